@@ -1,10 +1,9 @@
 #include "qtredmine/Logging.h"
 #include "CommandSender.h"
+#include "redtimer/ProfileStore.h"
 
 #include <QDataStream>
 #include <QLocalSocket>
-#include <QRegularExpression>
-#include <QSettings>
 #include <QVector>
 
 #include <iostream>
@@ -85,21 +84,8 @@ CommandSender::sendToAll( const CliOptions& options )
 
     singleServer_ = false;
 
-    QSettings settings( QSettings::IniFormat, QSettings::UserScope, "Thomssen IT", "RedTimer", this );
-
-    for( const auto& group : settings.childGroups() )
-    {
-        QRegularExpressionMatch match = QRegularExpression("profile-(\\d+)").match( group );
-
-        bool ok;
-        int profileId = match.captured(1).toInt( &ok );
-
-        // Not a profile group entry
-        if( !ok )
-            continue;
-
-        sendToServer( profileId, options );
-    }
+    for( const auto& profile : ProfileStore::profiles() )
+        sendToServer( profile.id, options );
 
     finished_ = true;
     if( sockets_.count() == 0 )
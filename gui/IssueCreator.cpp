@@ -13,9 +13,8 @@ using namespace std;
 
 namespace redtimer {
 
-IssueCreator::IssueCreator( SimpleRedmineClient* redmine, MainWindow* mainWindow )
-    : Window( "IssueCreator", mainWindow ),
-      redmine_( redmine )
+IssueCreator::IssueCreator( MainWindow* mainWindow )
+    : Window( "IssueCreator", mainWindow )
 {
     ENTER();
 
@@ -192,21 +191,24 @@ IssueCreator::loadAssignees()
         {
             int currentIndex = 0;
 
-            assigneeModel_.push_back( SimpleItem(NULL_ID, "") );
+            QList<SimpleItem> items;
+            items.push_back( SimpleItem(NULL_ID, "") );
             for( const auto& assignee : assignees )
             {
                 if( assignee.user.id == assigneeId_ || assignee.group.id == assigneeId_ )
                 {
-                    currentIndex = assigneeModel_.rowCount();
+                    currentIndex = items.size();
                     DEBUG("Selecting assignee")(assignee);
                 }
 
                 if( assignee.user.id != NULL_ID )
-                    assigneeModel_.push_back( SimpleItem(assignee.user) );
+                    items.push_back( SimpleItem(assignee.user) );
                 else if( assignee.group.id != NULL_ID )
-                    assigneeModel_.push_back( SimpleItem(assignee.group) );
+                    items.push_back( SimpleItem(assignee.group) );
             }
 
+            assigneeModel_.reset( items );
+
             qml("assignee")->setProperty( "currentIndex", currentIndex );
             qml("assignee")->setProperty( "enabled", true );
 
@@ -256,15 +258,18 @@ IssueCreator::loadCategories()
         {
             int currentIndex = 0;
 
-            categoryModel_.push_back( SimpleItem(NULL_ID, "") );
+            QList<SimpleItem> items;
+            items.push_back( SimpleItem(NULL_ID, "") );
             for( const auto& category : project.categories )
             {
                 if( category.id == categoryId_ )
-                    currentIndex = categoryModel_.rowCount();
+                    currentIndex = items.size();
 
-                categoryModel_.push_back( SimpleItem(category) );
+                items.push_back( SimpleItem(category) );
             }
 
+            categoryModel_.reset( items );
+
             qml("category")->setProperty( "currentIndex", currentIndex );
             qml("category")->setProperty( "enabled", true );
         }
@@ -534,7 +539,7 @@ IssueCreator::loadParentIssueData()
     }
 
     ++callbackCounter_;
-    redmine_->retrieveIssue( [=]( Issue issue, RedmineError redmineError, QStringList errors )
+    redmine_->retrieveIssue( [=]( Issue issue, RedmineError redmineError, int, QStringList errors )
     {
         CBENTER()(issue);
 
@@ -629,16 +634,18 @@ IssueCreator::loadProjects()
 
         int currentIndex = 0;
 
-        projectModel_.clear();
-        projectModel_.push_back( SimpleItem(NULL_ID, "Choose project") );
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose project") );
         for( const auto& project : projects )
         {
             if( projectId_ == project.id )
-                currentIndex = projectModel_.rowCount();
+                currentIndex = items.size();
 
-            projectModel_.push_back( SimpleItem(project) );
+            items.push_back( SimpleItem(project) );
         }
 
+        projectModel_.reset( items );
+
         qml("project")->setProperty( "currentIndex", -1 );
         qml("project")->setProperty( "currentIndex", currentIndex );
 
@@ -685,16 +692,18 @@ IssueCreator::loadTrackers()
 
         int currentIndex = 0;
 
-        trackerModel_.clear();
-        trackerModel_.push_back( SimpleItem(NULL_ID, "Choose tracker") );
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose tracker") );
         for( const auto& tracker : project.trackers )
         {
             if( tracker.id == trackerId_ )
-                currentIndex = trackerModel_.rowCount();
+                currentIndex = items.size();
 
-            trackerModel_.push_back( SimpleItem(tracker) );
+            items.push_back( SimpleItem(tracker) );
         }
 
+        trackerModel_.reset( items );
+
         qml("tracker")->setProperty( "currentIndex", -1 );
         qml("tracker")->setProperty( "currentIndex", currentIndex );
         qml("tracker")->setProperty( "enabled", true );
@@ -734,9 +743,9 @@ IssueCreator::loadVersions()
 
         int currentIndex = 0;
 
-        // Reset in case this has changed since calling loadVersions()
-        versionModel_.clear();
-        versionModel_.push_back( SimpleItem(NULL_ID, "") );
+        // Rebuild in case this has changed since calling loadVersions()
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "") );
 
         // Sort versions by due date
         sort( versions.begin(), versions.end(),
@@ -753,11 +762,13 @@ IssueCreator::loadVersions()
                 continue;
 
             if( version.id == versionId_ )
-                currentIndex = versionModel_.rowCount();
+                currentIndex = items.size();
 
-            versionModel_.push_back( SimpleItem(version) );
+            items.push_back( SimpleItem(version) );
         }
 
+        versionModel_.reset( items );
+
         DEBUG()(versionModel_)(currentIndex);
 
         qml("version")->setProperty( "currentIndex", -1 );
@@ -941,7 +952,7 @@ void
 IssueCreator::selectParentIssue()
 {
     // Issue selector initialisation
-    IssueSelector* issueSelector = new IssueSelector( redmine_, mainWindow() );
+    IssueSelector* issueSelector = new IssueSelector( mainWindow() );
     issueSelector->setTransientParent( this );
     if( projectId_ != NULL_ID )
         issueSelector->setProjectId( projectId_, true );
@@ -956,15 +967,15 @@ IssueCreator::selectParentIssue()
 }
 
 void
-IssueCreator::setCurrentIssue( Issue issue )
+IssueCreator::setCurrentIssue( IssueHandle issue )
 {
     ENTER();
 
-    if( issue.id != NULL_ID )
+    if( issue->id != NULL_ID )
     {
         issue_ = issue;
 
-        if( issue.parentId != NULL_ID )
+        if( issue->parentId != NULL_ID )
         {
             qml("useCurrentIssueParent")->setProperty( "visible", true );
             useCurrentIssueParent();
@@ -1019,10 +1030,10 @@ IssueCreator::useCurrentIssue()
 {
     ENTER();
 
-    if( issue_.id == NULL_ID )
+    if( issue_->id == NULL_ID )
         RETURN();
 
-    qml("parentIssue")->setProperty( "text", issue_.id );
+    qml("parentIssue")->setProperty( "text", issue_->id );
     loadParentIssueData();
 
     RETURN();
@@ -1033,10 +1044,10 @@ IssueCreator::useCurrentIssueParent()
 {
     ENTER();
 
-    if( issue_.parentId == NULL_ID )
+    if( issue_->parentId == NULL_ID )
         RETURN();
 
-    qml("parentIssue")->setProperty( "text", issue_.parentId );
+    qml("parentIssue")->setProperty( "text", issue_->parentId );
     loadParentIssueData();
 
     RETURN();
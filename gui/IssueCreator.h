@@ -15,9 +15,6 @@ class IssueCreator : public Window
     Q_OBJECT
 
 private:
-    /// Redmine connection object
-    qtredmine::SimpleRedmineClient* redmine_ = nullptr;
-
     /// Initial height
     int initHeight_;
 
@@ -64,7 +61,7 @@ private:
     QMap<int, SimpleModel*> customFieldModels_;
 
     /// Currently tracked issue
-    qtredmine::Issue issue_;
+    IssueHandle issue_ = IssueRegistry::null();
 
     /// Parent issue ID
     int parentIssueId_ = NULL_ID;
@@ -132,10 +129,9 @@ public:
     /**
      * @brief Constructor for an IssueCreator object
      *
-     * @param redmine Redmine connection object
      * @param mainWindow Main window object
      */
-    explicit IssueCreator( qtredmine::SimpleRedmineClient* redmine, MainWindow* mainWindow );
+    explicit IssueCreator( MainWindow* mainWindow );
 
     /**
      * @brief Destructor
@@ -160,9 +156,9 @@ public:
     /**
      * @brief Set the currently tracked issue
      *
-     * @param issue Currently tracked issue
+     * @param issue Handle of the currently tracked issue
      */
-    void setCurrentIssue( qtredmine::Issue issue );
+    void setCurrentIssue( IssueHandle issue );
 
     /**
      * @brief Set the currently selected project ID
@@ -8,9 +8,8 @@ using namespace std;
 
 namespace redtimer {
 
-IssueSelector::IssueSelector( SimpleRedmineClient* redmine, MainWindow* mainWindow )
-    : Window( "IssueSelector", mainWindow ),
-      redmine_( redmine )
+IssueSelector::IssueSelector( MainWindow* mainWindow )
+    : Window( "IssueSelector", mainWindow )
 {
     ENTER();
 
@@ -23,14 +22,85 @@ IssueSelector::IssueSelector( SimpleRedmineClient* redmine, MainWindow* mainWind
     setCtxProperty( "assigneeModel", &assigneeModel_ );
     setCtxProperty( "projectModel", &projectModel_ );
     setCtxProperty( "versionModel", &versionModel_ );
+    setCtxProperty( "queryModel", &queryModel_ );
+    setCtxProperty( "statusModel", &statusModel_ );
+    setCtxProperty( "trackerModel", &trackerModel_ );
+    setCtxProperty( "updatedModel", &updatedModel_ );
+
+    // Update periods in days
+    QList<SimpleItem> periods;
+    periods.push_back( SimpleItem(NULL_ID, "Updated any time") );
+    periods.push_back( SimpleItem(1, "Updated today") );
+    periods.push_back( SimpleItem(7, "Updated within a week") );
+    periods.push_back( SimpleItem(30, "Updated within a month") );
+    periods.push_back( SimpleItem(365, "Updated within a year") );
+    updatedModel_.reset( periods );
 
     issuesProxyModel_.setSourceModel( &issuesModel_ );
-    issuesProxyModel_.setSortRole( IssueModel::IssueRoles::IdRole );
     issuesProxyModel_.setDynamicSortFilter( true );
-    issuesProxyModel_.setFilterCaseSensitivity( Qt::CaseInsensitive );
-    issuesProxyModel_.setFilterRole( IssueModel::IssueRoles::SubjectRole );
     setCtxProperty( "issuesModel", &issuesProxyModel_ );
 
+    // Search issues while typing and show the matches at once
+    issueSearch_ = new IssueSearch( this );
+    connect( issueSearch_, &IssueSearch::finished, &issuesProxyModel_, &IssueFilterModel::setMatches );
+    connect( issueSearch_, &IssueSearch::cleared, &issuesProxyModel_, &IssueFilterModel::clearMatches );
+
+    // Update listed issues in place when they change elsewhere
+    connect( issueRegistry(), &IssueRegistry::changed, [=]( IssueHandle issue )
+    {
+        ENTER()(issue->id);
+
+        if( issuesModel_.update(*issue) )
+            issueSearch_->add( Issues{*issue} );
+
+        RETURN();
+    } );
+
+    // Display issues page by page as they arrive
+    issueLoader_ = new IssueListLoader( redmine_, this );
+
+    connect( issueLoader_, &IssueListLoader::pageLoaded,
+             [=]( IssueStore::Block block, bool first, int loaded )
+    {
+        ENTER()(block.size())(first)(loaded);
+
+        if( first )
+            issueSearch_->clear();
+
+        issueSearch_->add( block );
+
+        if( first )
+            issuesModel_.reset( block );
+        else
+            issuesModel_.append( block );
+
+        qml("progress")->setProperty( "text", tr("Loading issues... %1 loaded").arg(loaded) );
+
+        RETURN();
+    } );
+
+    connect( issueLoader_, &IssueListLoader::finished, [=]( int loaded )
+    {
+        ENTER()(loaded);
+        qml("progress")->setProperty( "text", tr("%1 issues").arg(loaded) );
+        RETURN();
+    } );
+
+    connect( issueLoader_, &IssueListLoader::failed, [=]( QStringList errors )
+    {
+        ENTER()(errors);
+
+        qml("progress")->setProperty( "text", QString() );
+
+        QString errorMsg = tr("Could not load issues.");
+        for( const auto& error : errors )
+            errorMsg.append("\n").append(error);
+
+        message( errorMsg, QtCriticalMsg );
+
+        RETURN();
+    } );
+
     // Connect the assignee selected signal to the assigneeSelected slot
     connect( qml("assignee"), SIGNAL(activated(int)), this, SLOT(assigneeSelected(int)) );
 
@@ -40,19 +110,32 @@ IssueSelector::IssueSelector( SimpleRedmineClient* redmine, MainWindow* mainWind
     // Connect the project selected signal to the projectSelected slot
     connect( qml("project"), SIGNAL(activated(int)), this, SLOT(projectSelected(int)) );
 
-    // Connect the search accepted signal to the filterIssues slot
+    // Connect the search changed signal to the filterIssues slot
     connect( qml("search"), SIGNAL(textChanged()), this, SLOT(filterIssues()) );
 
+    // Connect the search accepted signal to the searchIssues slot
+    connect( qml("search"), SIGNAL(accepted()), this, SLOT(searchIssues()) );
+
+    // Connect the query selected signal to the querySelected slot
+    connect( qml("query"), SIGNAL(activated(int)), this, SLOT(querySelected(int)) );
+
+    // Connect the status selected signal to the statusSelected slot
+    connect( qml("status"), SIGNAL(activated(int)), this, SLOT(statusSelected(int)) );
+
+    // Connect the tracker selected signal to the trackerSelected slot
+    connect( qml("tracker"), SIGNAL(activated(int)), this, SLOT(trackerSelected(int)) );
+
+    // Connect the updated selected signal to the updatedSelected slot
+    connect( qml("updated"), SIGNAL(activated(int)), this, SLOT(updatedSelected(int)) );
+
     // Connect the version selected signal to the versionSelected slot
     connect( qml("version"), SIGNAL(activated(int)), this, SLOT(versionSelected(int)) );
 
     // Connect the closed signal to the close slot
     connect( this, &Window::closed, [=](){ close(); } );
 
+    // Lists are loaded when the issue selector is displayed
     projectId_ = profileData()->projectId;
-    loadProjects();
-    loadAssignees();
-    loadVersions();
 
     RETURN();
 }
@@ -62,6 +145,8 @@ IssueSelector::close()
 {
     ENTER();
 
+    issueLoader_->cancel();
+
     settings()->windowData()->issueSelector = getWindowData();
     settings()->save();
 
@@ -79,9 +164,17 @@ IssueSelector::display()
 
     show();
 
-    if( projectModel_.rowCount() == 0 )
+    if( !projectsLoaded_ )
         loadProjects();
 
+    if( !filtersLoaded_ )
+    {
+        filtersLoaded_ = true;
+        loadQueries();
+        loadStatuses();
+        loadTrackers();
+    }
+
     RETURN();
 }
 
@@ -91,7 +184,9 @@ IssueSelector::filterIssues()
     ENTER();
 
     QString filter = qml("search")->property("text").toString();
-    issuesProxyModel_.setFilterFixedString( filter );
+
+    // Custom field terms are only evaluated by Redmine
+    issueSearch_->search( IssueFilter::localSearchText(filter) );
 
     RETURN();
 }
@@ -137,10 +232,82 @@ IssueSelector::projectSelected( int index )
 
     // Ensure that no old issues are displayed
     issuesModel_.clear();
+    issueSearch_->clear();
 
     // Load dependent filters
     loadAssignees();
     loadVersions();
+    loadQueries();
+
+    loadIssues();
+
+    RETURN();
+}
+
+void
+IssueSelector::querySelected( int index )
+{
+    ENTER();
+
+    filter_.queryId = queryModel_.at(index).id();
+    DEBUG()(index)(filter_.queryId);
+
+    loadIssues();
+
+    RETURN();
+}
+
+void
+IssueSelector::searchIssues()
+{
+    ENTER();
+
+    filter_.setSearchText( qml("search")->property("text").toString() );
+    DEBUG()(filter_.subject)(filter_.customFields);
+
+    loadIssues();
+
+    RETURN();
+}
+
+void
+IssueSelector::statusSelected( int index )
+{
+    ENTER();
+
+    filter_.statusId = statusModel_.at(index).id();
+    DEBUG()(index)(filter_.statusId);
+
+    loadIssues();
+
+    RETURN();
+}
+
+void
+IssueSelector::trackerSelected( int index )
+{
+    ENTER();
+
+    filter_.trackerId = trackerModel_.at(index).id();
+    DEBUG()(index)(filter_.trackerId);
+
+    loadIssues();
+
+    RETURN();
+}
+
+void
+IssueSelector::updatedSelected( int index )
+{
+    ENTER();
+
+    int days = updatedModel_.at(index).id();
+    DEBUG()(index)(days);
+
+    if( days == NULL_ID )
+        filter_.updatedFrom = QDate();
+    else
+        filter_.updatedFrom = QDate::currentDate().addDays( 1 - days );
 
     loadIssues();
 
@@ -196,9 +363,9 @@ IssueSelector::loadAssignees()
 
         int currentIndex = 0;
 
-        // Reset in case this has changed since calling loadAssignees()
-        assigneeModel_.clear();
-        assigneeModel_.push_back( SimpleItem(NULL_ID, "Choose assignee") );
+        // Rebuild in case this has changed since calling loadAssignees()
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose assignee") );
 
         // Sort assignees by name
         sort( assignees.begin(), assignees.end(),
@@ -222,14 +389,16 @@ IssueSelector::loadAssignees()
         for( const auto& assignee : assignees )
         {
             if( assignee.id == assigneeId_ )
-                currentIndex = assigneeModel_.rowCount();
+                currentIndex = items.size();
 
             if( assignee.user.id != NULL_ID )
-                assigneeModel_.push_back( SimpleItem(assignee.user) );
+                items.push_back( SimpleItem(assignee.user) );
             else if( assignee.group.id != NULL_ID )
-                assigneeModel_.push_back( SimpleItem(assignee.group) );
+                items.push_back( SimpleItem(assignee.group) );
         }
 
+        assigneeModel_.reset( items );
+
         DEBUG()(assigneeModel_)(currentIndex);
 
         qml("assignee")->setProperty( "currentIndex", -1 );
@@ -255,54 +424,94 @@ IssueSelector::loadIssues()
     if( versionId_ != NULL_ID )
         parameters.append( QString("&fixed_version_id=%1").arg(versionId_) );
 
+    // Let Redmine filter the issues so that only matching issues are transferred
+    QString filterParameters = filter_.parameters();
+    if( !filterParameters.isEmpty() )
+        parameters.append( "&" ).append( filterParameters );
+
     if( !connected() )
         RETURN();
 
+    qml("progress")->setProperty( "text", tr("Loading issues...") );
+
+    issueLoader_->start( parameters );
+
+    RETURN();
+}
+
+void
+IssueSelector::loadProjects()
+{
+    ENTER();
+
+    if( !connected() )
+        RETURN();
+
+    projectsLoaded_ = true;
+
     ++callbackCounter_;
-    redmine_->retrieveIssues( [&]( Issues issues, RedmineError redmineError, QStringList errors )
+    redmine_->retrieveProjects( [=]( Projects projects, RedmineError redmineError, QStringList errors )
     {
         CBENTER();
 
         if( redmineError != RedmineError::NO_ERR )
         {
-            QString errorMsg = tr("Could not load issues.");
+            QString errorMsg = tr("Could not load projects.");
             for( const auto& error : errors )
                 errorMsg.append("\n").append(error);
 
+            projectsLoaded_ = false;
+
             message( errorMsg, QtCriticalMsg );
             CBRETURN();
         }
 
-        issuesModel_.clear();
+        int currentIndex = 0;
+
+        // Rebuild in case this has changed since calling loadProjects()
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose project") );
+
+        for( const auto& project : projects )
+        {
+            if( project.id == projectId_ )
+                currentIndex = items.size();
+
+            QString name = project.name;
+            if( project.parent.id != NULL_ID )
+                name.prepend( "- " );
 
-        for( const auto& issue : issues )
-            issuesModel_.push_back( issue );
+            items.push_back( SimpleItem(project.id, name) );
+        }
+
+        projectModel_.reset( items );
 
-        DEBUG()(issuesModel_);
+        DEBUG()(projectModel_)(currentIndex);
+
+        qml("project")->setProperty( "currentIndex", -1 );
+        qml("project")->setProperty( "currentIndex", currentIndex );
 
         CBRETURN();
     },
-    RedmineOptions( parameters, true ) );
-
-    RETURN();
+    QString("limit=100") );
 }
 
 void
-IssueSelector::loadProjects()
+IssueSelector::loadQueries()
 {
-    ENTER();
+    ENTER()(projectId_);
 
     if( !connected() )
         RETURN();
 
     ++callbackCounter_;
-    redmine_->retrieveProjects( [=]( Projects projects, RedmineError redmineError, QStringList errors )
+    redmine_->retrieveQueries( [=]( SavedQueries queries, RedmineError redmineError, QStringList errors )
     {
         CBENTER();
 
         if( redmineError != RedmineError::NO_ERR )
         {
-            QString errorMsg = tr("Could not load projects.");
+            QString errorMsg = tr("Could not load saved queries.");
             for( const auto& error : errors )
                 errorMsg.append("\n").append(error);
 
@@ -312,32 +521,143 @@ IssueSelector::loadProjects()
 
         int currentIndex = 0;
 
-        // Reset in case this has changed since calling loadProjects()
-        projectModel_.clear();
-        projectModel_.push_back( SimpleItem(NULL_ID, "Choose project") );
+        // Rebuild in case this has changed since calling loadQueries()
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose saved query") );
 
-        for( const auto& project : projects )
+        for( const auto& query : queries )
         {
-            if( project.id == projectId_ )
-                currentIndex = projectModel_.rowCount();
+            // Only offer global queries and queries of the current project
+            if( query.projectId != NULL_ID && query.projectId != projectId_ )
+                continue;
 
-            QString name = project.name;
-            if( project.parent.id != NULL_ID )
-                name.prepend( "- " );
+            if( query.id == filter_.queryId )
+                currentIndex = items.size();
 
-            projectModel_.push_back( SimpleItem(project.id, name) );
+            items.push_back( SimpleItem(query) );
         }
 
-        DEBUG()(projectModel_)(currentIndex);
+        // The saved query does not apply to this project
+        if( currentIndex == 0 && filter_.queryId != NULL_ID )
+        {
+            filter_.queryId = NULL_ID;
+            loadIssues();
+        }
 
-        qml("project")->setProperty( "currentIndex", -1 );
-        qml("project")->setProperty( "currentIndex", currentIndex );
+        queryModel_.reset( items );
+
+        DEBUG()(queryModel_)(currentIndex);
+
+        qml("query")->setProperty( "currentIndex", -1 );
+        qml("query")->setProperty( "currentIndex", currentIndex );
 
         CBRETURN();
     },
     QString("limit=100") );
 }
 
+void
+IssueSelector::loadStatuses()
+{
+    ENTER();
+
+    if( !connected() )
+        RETURN();
+
+    ++callbackCounter_;
+    metadataCache()->retrieveIssueStatuses( [=]( IssueStatuses issueStatuses, RedmineError redmineError,
+                                                 QStringList errors )
+    {
+        CBENTER();
+
+        if( redmineError != RedmineError::NO_ERR )
+        {
+            QString errorMsg = tr("Could not load issue statuses.");
+            for( const auto& error : errors )
+                errorMsg.append("\n").append(error);
+
+            message( errorMsg, QtCriticalMsg );
+            CBRETURN();
+        }
+
+        int currentIndex = 0;
+
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Open issues") );
+        items.push_back( SimpleItem(IssueFilter::CLOSED_STATUSES, "Closed issues") );
+        items.push_back( SimpleItem(IssueFilter::ALL_STATUSES, "All issues") );
+
+        for( const auto& issueStatus : issueStatuses )
+        {
+            if( issueStatus.id == filter_.statusId )
+                currentIndex = items.size();
+
+            items.push_back( SimpleItem(issueStatus) );
+        }
+
+        if( filter_.statusId == IssueFilter::CLOSED_STATUSES )
+            currentIndex = 1;
+        else if( filter_.statusId == IssueFilter::ALL_STATUSES )
+            currentIndex = 2;
+
+        statusModel_.reset( items );
+
+        DEBUG()(statusModel_)(currentIndex);
+
+        qml("status")->setProperty( "currentIndex", -1 );
+        qml("status")->setProperty( "currentIndex", currentIndex );
+
+        CBRETURN();
+    } );
+}
+
+void
+IssueSelector::loadTrackers()
+{
+    ENTER();
+
+    if( !connected() )
+        RETURN();
+
+    ++callbackCounter_;
+    metadataCache()->retrieveTrackers( [=]( Trackers trackers, RedmineError redmineError, QStringList errors )
+    {
+        CBENTER();
+
+        if( redmineError != RedmineError::NO_ERR )
+        {
+            QString errorMsg = tr("Could not load trackers.");
+            for( const auto& error : errors )
+                errorMsg.append("\n").append(error);
+
+            message( errorMsg, QtCriticalMsg );
+            CBRETURN();
+        }
+
+        int currentIndex = 0;
+
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose tracker") );
+
+        for( const auto& tracker : trackers )
+        {
+            if( tracker.id == filter_.trackerId )
+                currentIndex = items.size();
+
+            items.push_back( SimpleItem(tracker) );
+        }
+
+        trackerModel_.reset( items );
+
+        DEBUG()(trackerModel_)(currentIndex);
+
+        qml("tracker")->setProperty( "currentIndex", -1 );
+        qml("tracker")->setProperty( "currentIndex", currentIndex );
+
+        CBRETURN();
+    } );
+}
+
 void
 IssueSelector::loadVersions()
 {
@@ -374,9 +694,9 @@ IssueSelector::loadVersions()
 
         int currentIndex = 0;
 
-        // Reset in case this has changed since calling loadVersions()
-        versionModel_.clear();
-        versionModel_.push_back( SimpleItem(NULL_ID, "Choose version") );
+        // Rebuild in case this has changed since calling loadVersions()
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose version") );
 
         // Sort versions by due date
         sort( versions.begin(), versions.end(),
@@ -393,11 +713,13 @@ IssueSelector::loadVersions()
                 continue;
 
             if( version.id == versionId_ )
-                currentIndex = versionModel_.rowCount();
+                currentIndex = items.size();
 
-            versionModel_.push_back( SimpleItem(version) );
+            items.push_back( SimpleItem(version) );
         }
 
+        versionModel_.reset( items );
+
         DEBUG()(versionModel_)(currentIndex);
 
         qml("version")->setProperty( "currentIndex", -1 );
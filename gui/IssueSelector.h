@@ -4,8 +4,9 @@
 #include "Models.h"
 #include "Window.h"
 #include "qtredmine/SimpleRedmineClient.h"
-
-#include <QSortFilterProxyModel>
+#include "redtimer/IssueFilter.h"
+#include "redtimer/IssueListLoader.h"
+#include "redtimer/IssueSearch.h"
 
 namespace redtimer {
 
@@ -17,12 +18,21 @@ class IssueSelector : public Window
     Q_OBJECT
 
 private:
-    /// Redmine connection object
-    qtredmine::SimpleRedmineClient* redmine_;
-
     /// List of issues in the GUI
     IssueModel issuesModel_;
-    QSortFilterProxyModel issuesProxyModel_;
+    IssueFilterModel issuesProxyModel_;
+
+    /// Full-text search over the issues in the GUI
+    IssueSearch* issueSearch_;
+
+    /// Page-wise loader for the list of issues
+    IssueListLoader* issueLoader_;
+
+    /// Filter lists have been loaded
+    bool filtersLoaded_ = false;
+
+    /// Project list has been requested
+    bool projectsLoaded_ = false;
 
     /// Current project
     int projectId_ = NULL_ID;
@@ -42,14 +52,28 @@ private:
     /// List of versions in the GUI
     SimpleModel versionModel_;
 
+    /// Filters that are evaluated by Redmine
+    IssueFilter filter_;
+
+    /// List of saved queries in the GUI
+    SimpleModel queryModel_;
+
+    /// List of issue statuses in the GUI
+    SimpleModel statusModel_;
+
+    /// List of trackers in the GUI
+    SimpleModel trackerModel_;
+
+    /// List of update periods in the GUI
+    SimpleModel updatedModel_;
+
 public:
     /**
      * @brief Constructor for an IssueSelector object
      *
-     * @param redmine Redmine connection object
      * @param mainWindow Main window object
      */
-    explicit IssueSelector( qtredmine::SimpleRedmineClient* redmine, MainWindow* mainWindow );
+    explicit IssueSelector( MainWindow* mainWindow );
 
     /// @name Getters
     /// @{
@@ -138,6 +162,31 @@ private slots:
      */
     void projectSelected( int index );
 
+    /**
+     * @brief Slot to a selected saved query
+     */
+    void querySelected( int index );
+
+    /**
+     * @brief Search issues on the server using the filter text field
+     */
+    void searchIssues();
+
+    /**
+     * @brief Slot to a selected issue status
+     */
+    void statusSelected( int index );
+
+    /**
+     * @brief Slot to a selected tracker
+     */
+    void trackerSelected( int index );
+
+    /**
+     * @brief Slot to a selected update period
+     */
+    void updatedSelected( int index );
+
     /**
      * @brief Slot to a selected version
      */
@@ -158,6 +207,21 @@ private slots:
      */
     void loadProjects();
 
+    /**
+     * @brief Update saved queries and refresh saved query list
+     */
+    void loadQueries();
+
+    /**
+     * @brief Update issue statuses and refresh issue status list
+     */
+    void loadStatuses();
+
+    /**
+     * @brief Update trackers and refresh tracker list
+     */
+    void loadTrackers();
+
     /**
      * @brief Update versions and refresh version list
      */
@@ -1,13 +1,13 @@
 #include "qtredmine/Logging.h"
 #include "qtredmine/SimpleRedmineTypes.h"
 #include "redtimer/CliOptions.h"
+#include "redtimer/StringPool.h"
 
 #include "IssueCreator.h"
 #include "IssueSelector.h"
 #include "MainWindow.h"
 #include "Settings.h"
 
-#include <QEventLoop>
 #include <QLocalServer>
 #include <QLocalSocket>
 #include <QMessageBox>
@@ -24,14 +24,21 @@ namespace redtimer {
 
 #define MSG_CANNOT_PROCEDE "Cannot procede without a connection"
 
+/// HTTP status codes of issues that are not accessible
+#define HTTP_FORBIDDEN 403
+#define HTTP_NOT_FOUND 404
+
 MainWindow::MainWindow( QApplication* parent, QString profileId )
     : Window( "MainWindow", this ),
       app_( parent )
 {
     ENTER();
 
-    // Connect to Redmine
-    redmine_ = new SimpleRedmineClient( this );
+    // Connect to Redmine using a session that is shared by all windows
+    redmine_ = new RedmineSession( this );
+    metadataCache_ = new MetadataCache( redmine_, this );
+    issueRegistry_ = new IssueRegistry( this );
+    journal_ = new TimeEntryJournal( redmine_, this );
 
     // Settings initialisation
     settings_ = new Settings( this, profileId );
@@ -81,6 +88,109 @@ MainWindow::MainWindow( QApplication* parent, QString profileId )
     // Notify upon connection status change
     connect( redmine_, &SimpleRedmineClient::connectionChanged, this, &MainWindow::notifyConnectionStatus );
 
+    // Reload cached enumerations if they have changed on the server
+    connect( metadataCache_, &MetadataCache::changed, [=]( const QString& key )
+    {
+        ENTER()(key);
+
+        if( key == "activities" )
+            loadActivities();
+        else if( key == "issueStatuses" )
+            loadIssueStatuses();
+
+        RETURN();
+    } );
+
+    // Update the recent issues and the current issue in place when an issue changes
+    connect( issueRegistry_, &IssueRegistry::changed, [=]( IssueHandle issue )
+    {
+        ENTER()(issue->id);
+
+        recentIssues_.update( *issue );
+
+        if( issue->id == issue_->id )
+        {
+            issue_ = issue;
+            displayIssue( *issue_ );
+            loadIssueStatuses();
+        }
+
+        RETURN();
+    } );
+
+    // Report the results of sending journaled time entries and issue updates
+    connect( journal_, &TimeEntryJournal::timeEntrySent,
+             [=]( TimeEntry timeEntry, bool success, RedmineError errorCode, QStringList errors )
+    {
+        ENTER()(timeEntry.issue.id)(success)(errorCode)(errors);
+
+        if( errorCode == RedmineError::ERR_TIME_ENTRY_TOO_SHORT )
+        {
+            message( tr("Not saving too short time entries."), QtWarningMsg );
+        }
+        else if( !success )
+        {
+            QString errorMsg = tr( "Could not send the time entry to Redmine. It will be sent again later." );
+            for( const auto& error : errors )
+                errorMsg.append("\n").append(error);
+            message( errorMsg, QtCriticalMsg );
+        }
+
+        RETURN();
+    } );
+
+    connect( journal_, &TimeEntryJournal::issueStatusSent,
+             [=]( int issueId, int statusId, bool success, RedmineError errorCode, QStringList errors )
+    {
+        ENTER()(issueId)(statusId)(success)(errorCode)(errors);
+
+        if( !success )
+        {
+            QString errorMsg = tr( "Could not update the issue. It will be updated again later." );
+            for( const auto& error : errors )
+                errorMsg.append("\n").append(error);
+            message( errorMsg, QtCriticalMsg );
+            RETURN();
+        }
+
+        message( tr("Issue updated") );
+
+        if( issueId == issue_->id )
+            loadIssueStatuses();
+
+        RETURN();
+    } );
+
+    connect( journal_, &TimeEntryJournal::timeEntryRejected, [=]( TimeEntry timeEntry, QStringList errors )
+    {
+        ENTER()(timeEntry.issue.id)(timeEntry.hours)(errors);
+
+        QString errorMsg = tr( "Redmine rejected the time entry of %1 for issue #%2. It will not be sent again." )
+                           .arg( QTime(0, 0, 0).addSecs(qRound(timeEntry.hours * 3600)).toString("HH:mm:ss") )
+                           .arg( timeEntry.issue.id );
+        for( const auto& error : errors )
+            errorMsg.append("\n").append(error);
+        message( errorMsg, QtCriticalMsg );
+
+        RETURN();
+    } );
+
+    connect( journal_, &TimeEntryJournal::issueStatusRejected, [=]( int issueId, int statusId, QStringList errors )
+    {
+        ENTER()(issueId)(statusId)(errors);
+
+        QString errorMsg = tr( "Redmine rejected the update of issue #%1. It will not be sent again." ).arg( issueId );
+        for( const auto& error : errors )
+            errorMsg.append("\n").append(error);
+        message( errorMsg, QtCriticalMsg );
+
+        // Replace the optimistic issue status with the actual one
+        if( issueId == issue_->id )
+            loadIssue( issueId, false, false );
+
+        RETURN();
+    } );
+
     setCtxProperty( "activityModel",     &activityModel_ );
     setCtxProperty( "issueStatusModel",  &issueStatusModel_ );
     setCtxProperty( "recentIssuesModel", &recentIssues_ );
@@ -122,7 +232,7 @@ MainWindow::MainWindow( QApplication* parent, QString profileId )
     // Connect the settings saved signal to the settingsApplied (including reconnect) slot
     connect( settings_, &Settings::applied, this, &MainWindow::settingsApplied );
 
-    // Connect the timer to the tracking counter
+    // Connect the timer to the displayed counter
     connect( timer_, &QTimer::timeout, this, &MainWindow::refreshCounter );
 
     // Initially check the Redmine connection
@@ -130,20 +240,8 @@ MainWindow::MainWindow( QApplication* parent, QString profileId )
 
     qml("quickPick")->setProperty( "editText", quickPick_ );
 
-    // Issue selector initialisation
-    issueSelector_ = new IssueSelector( redmine_, this );
-    issueSelector_->setTransientParent( this );
-
-    // Connect the issue selected signal to the setIssue slot
-    connect( issueSelector_, &IssueSelector::selected, [=](int issueId)
-    {
-        ENTER()(issueId);
-
-        profileData()->projectId = issueSelector_->getProjectId();
-        loadIssue( issueId );
-
-        RETURN();
-    } );
+    // Prepare the issue selector once the main window is idle; its data is loaded when it is displayed
+    QTimer::singleShot( IDLE_DELAY, this, [=](){ issueSelector(); } );
 
     server = new QLocalServer( this );
     server->setSocketOptions( QLocalServer::UserAccessOption );
@@ -172,9 +270,9 @@ MainWindow::addRecentIssue( qtredmine::Issue issue )
     ENTER()(issue);
 
     // If found, remove the new issue from the list
-    for( int i = 0; i < recentIssues_.rowCount(); ++i )
-        if( recentIssues_.at(i).id == issue.id )
-            recentIssues_.removeRow( i );
+    int row = recentIssues_.indexOf( issue.id );
+    if( row != -1 )
+        recentIssues_.removeRow( row );
 
     // Add the issue to the top of the list
     recentIssues_.push_front( issue );
@@ -203,9 +301,9 @@ MainWindow::connected()
 double
 MainWindow::counter()
 {
-    ENTER()(counterDiff_);
+    ENTER();
 
-    int value = counterNoDiff() + counterDiff_;
+    int value = engine_.seconds();
 
     RETURN( value );
 }
@@ -218,6 +316,10 @@ MainWindow::counterGui()
     if( !qml("counter") )
         RETURN( 0 );
 
+    // The displayed counter is not refreshed while it is invisible, so derive it on demand
+    if( engine_.isRunning() && updateCounterGui_ )
+        RETURN( counter() );
+
     int value = 0;
     QTime time = SimpleRedmineClient::getTime( qml("counter")->property("text").toString() );
     if( time.isValid() )
@@ -226,26 +328,16 @@ MainWindow::counterGui()
     RETURN( value );
 }
 
-double
-MainWindow::counterNoDiff()
-{
-    ENTER();
-
-    int value = lastCounterUpdated_.secsTo(QDateTime::currentDateTimeUtc());
-
-    RETURN( value );
-}
-
 void
 MainWindow::createIssue()
 {
     ENTER();
 
     // Save time on current issue if timer is running
-    if( timer_->isActive() && issue_.id != NULL_ID )
-        stop( true, false );
+    if( engine_.isRunning() && issue_->id != NULL_ID )
+        stop( false );
 
-    if( !timer_->isActive() )
+    if( !engine_.isRunning() )
         startTimer();
 
     const ProfileData* data = profileData();
@@ -254,7 +346,7 @@ MainWindow::createIssue()
     display();
 
     // Display the issue creator with the current issue as parent
-    IssueCreator* issueCreator = new IssueCreator( redmine_, this );
+    IssueCreator* issueCreator = new IssueCreator( this );
     issueCreator->setTransientParent( this );
     issueCreator->setCurrentIssue( issue_ );
     issueCreator->setProjectId( data->projectId );
@@ -263,13 +355,13 @@ MainWindow::createIssue()
 
     // Empty the issue information and set ID to NULL_ID
     resetGui( "<New issue>" );
-    issue_.id = NULL_ID;
+    issue_ = IssueRegistry::null();
 
     // Connect the issue selected signal to the setIssue slot
     connect( issueCreator, &IssueCreator::cancelled, [=]()
     {
         if( recentIssues_.rowCount() )
-            loadIssue( recentIssues_.at(0).id );
+            loadIssue( recentIssues_.idAt(0) );
         else
             resetGui();
     } );
@@ -299,6 +391,106 @@ MainWindow::display()
     showNormal();
 
     hidden_ = false;
+    updateCounterTimer();
+
+    RETURN();
+}
+
+void
+MainWindow::displayIssue( const Issue& issue )
+{
+    ENTER()(issue);
+
+    qml("issueId")->setProperty( "text", QString("Issue ID: %1").arg(issue.id) );
+    qml("issueId")->setProperty( "cursorPosition", 0 );
+    qml("subject")->setProperty( "text", issue.subject );
+    qml("subject")->setProperty( "cursorPosition", 0 );
+    qml("description")->setProperty( "text", issue.description );
+
+    QString more;
+    if( issue.tracker.id != NULL_ID )
+        more.append( QString("<b>Tracker:</b> %1<br>").arg(issue.tracker.name) );
+    if( issue.category.id != NULL_ID )
+        more.append( QString("<b>Category:</b> %1<br>").arg(issue.category.name) );
+    if( issue.version.id != NULL_ID )
+        more.append( QString("<b>Target version:</b> %1<br>").arg(issue.version.name) );
+    if( issue.parentId != NULL_ID )
+        more.append( QString("<b>Parent issue ID:</b> %1<br>").arg(issue.parentId) );
+
+    QString customFields;
+    bool displayCustomFields = false;
+    for( const auto& customField : issue.customFields )
+    {
+        if( !customField.values.size()
+            || (customField.values.size() == 1 && customField.values[0].isEmpty()) )
+            continue;
+
+        displayCustomFields = true;
+
+        QString value;
+
+        for( const auto& val : customField.values )
+        {
+            if( !value.isEmpty() )
+                value.append( ", " );
+
+            value.append( val );
+        }
+
+        customFields.append( QString("<b>%1:</b> %2<br>").arg(customField.name).arg(value) );
+    }
+    if( displayCustomFields )
+        more.append( customFields );
+
+    if( more.isEmpty() )
+    {
+        qml("more")->setProperty( "visible", false );
+    }
+    else
+    {
+        // Remove the last <br>
+        more.chop(4);
+        qml("more")->setProperty( "text", more );
+        qml("more")->setProperty( "visible", true );
+    }
+
+    updateTitle();
+
+    RETURN();
+}
+
+void
+MainWindow::drainJournal( std::function<void()> cb )
+{
+    ENTER();
+
+    if( journal_->isEmpty() || !connected() )
+    {
+        cb();
+        RETURN();
+    }
+
+    auto done = make_shared<bool>( false );
+    auto connection = make_shared<QMetaObject::Connection>();
+
+    auto finish = [=]()
+    {
+        ENTER()(*done);
+
+        if( *done )
+            RETURN();
+
+        *done = true;
+        disconnect( *connection );
+        cb();
+
+        RETURN();
+    };
+
+    *connection = connect( journal_, &TimeEntryJournal::drained, this, finish );
+    QTimer::singleShot( DRAIN_TIMEOUT, this, finish );
+
+    journal_->replay();
 
     RETURN();
 }
@@ -309,6 +501,7 @@ MainWindow::hide()
     ENTER();
 
     hidden_ = true;
+    updateCounterTimer();
 
 #ifdef Q_OS_OSX
     TransformProcessType( &psn_, kProcessTransformToUIElementApplication );
@@ -353,6 +546,10 @@ MainWindow::event( QEvent* event )
         return true;
     }
 
+    // Refresh the counter only while it is visible
+    if( event->type() == QEvent::Expose )
+        updateCounterTimer();
+
     return Window::event( event );
 }
 
@@ -373,7 +570,7 @@ MainWindow::exit()
     }
 
     // Show warning on close and if timer is running
-    if( timer_->isActive() || counterGui() != 0 )
+    if( engine_.isRunning() || counterGui() != 0 )
     {
         DEBUG() << "Received close event while timer is running";
 
@@ -395,19 +592,18 @@ MainWindow::exit()
                 DEBUG() << "Saving time entry before closing the application";
 
                 // Only go on with closing the window if saving was successful
-                // If saving was successful before the blocker has been started, do not start it at all
-                QEventLoop* blocker = new QEventLoop();
-                bool startBlocker = true;
-                connect( this, &MainWindow::timeEntrySaved, [&]()
+                // Saving only writes to the local journal and does not wait for Redmine
+                bool saved = false;
+                stop( true, [&saved]( bool success, int, RedmineError, QStringList )
                 {
-                    startBlocker = false;
-                    blocker->exit();
+                    saved = success;
                 } );
 
-                stop();
-
-                if( startBlocker )
-                    blocker->exec();
+                if( !saved )
+                {
+                    DEBUG() << "Time entry could not be saved, not closing the application";
+                    RETURN();
+                }
             }
 
             default:
@@ -419,12 +615,30 @@ MainWindow::exit()
     if( trayIcon_ )
         trayIcon_->hide();
 
-    // Save settings
+    // Save settings and wait until they have been written
     saveSettings();
+    settings_->sync();
+    saveSnapshot();
 
     server->close();
 
-    app_->quit();
+    DEBUG() << "Memory report:" << StringPool::instance().report();
+
+    // Give the uploader a short time to send journaled entries; remaining entries are sent upon the next start
+    if( journal_->isEmpty() || !connected() )
+    {
+        DEBUG() << "Quitting app";
+        app_->quit();
+
+        RETURN();
+    }
+
+    DEBUG() << "Quitting app after sending journaled entries";
+
+    hide();
+
+    connect( journal_, SIGNAL(drained()), app_, SLOT(quit()) );
+    QTimer::singleShot( EXIT_TIMEOUT, app_, SLOT(quit()) );
 
     RETURN();
 }
@@ -510,10 +724,10 @@ MainWindow::issueStatusSelected( int index )
 {
     ENTER();
 
-    issue_.status.id = issueStatusModel_.at(index).id();
-    DEBUG()(index)(issue_.status.id);
+    int statusId = issueStatusModel_.at(index).id();
+    DEBUG()(index)(statusId);
 
-    updateIssueStatus( issue_.status.id );
+    updateIssueStatus( statusId );
 
     RETURN();
 }
@@ -527,8 +741,8 @@ MainWindow::loadActivities()
         RETURN();
 
     ++callbackCounter_;
-    redmine_->retrieveTimeEntryActivities( [&]( Enumerations activities, RedmineError redmineError,
-                                                QStringList errors )
+    metadataCache_->retrieveTimeEntryActivities( [&]( Enumerations activities, RedmineError redmineError,
+                                                      QStringList errors )
     {
         CBENTER()(redmineError)(errors);
 
@@ -547,16 +761,18 @@ MainWindow::loadActivities()
 
         int currentIndex = 0;
 
-        activityModel_.clear();
-        activityModel_.push_back( SimpleItem(NULL_ID, "Choose activity") );
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose activity") );
         for( const auto& activity : activities )
         {
             if( activity.id == activityId_ )
-                currentIndex = activityModel_.rowCount();
+                currentIndex = items.size();
 
-            activityModel_.push_back( SimpleItem(activity) );
+            items.push_back( SimpleItem(activity) );
         }
 
+        activityModel_.reset( items );
+
         DEBUG()(activityModel_)(activityId_)(currentIndex);
 
         qml("activity")->setProperty( "currentIndex", -1 );
@@ -573,7 +789,7 @@ MainWindow::loadIssueFromList( int index )
 {
     ENTER()(index);
 
-    loadIssue( recentIssues_.at(index).id );
+    loadIssue( recentIssues_.idAt(index) );
 
     RETURN();
 }
@@ -609,16 +825,22 @@ MainWindow::loadIssue( int issueId, bool startTimer, bool saveNewIssue )
 {
     ENTER()(issueId)(startTimer)(saveNewIssue);
 
-    if( !connected() )
+    // Without a connection, issues can only be loaded from the cache
+    if( !connected() && issueId != NULL_ID && !issueCache_.contains(issueId) )
         RETURN();
 
     // If the timer is currently active, save the currently logged time first
     // If there will be no new issue selected, stop the timer
-    if( startTimer && timer_->isActive() )
-        stop( true, issueId == NULL_ID );
+    if( startTimer && engine_.isRunning() )
+        stop( issueId == NULL_ID );
 
-    if( saveNewIssue )
-        issue_.id = issueId;
+    // Keep the ID of the new issue until it has been loaded
+    if( saveNewIssue && issue_->id != issueId )
+    {
+        Issue issue;
+        issue.id = issueId;
+        issue_ = IssueHandle::create( issue );
+    }
 
     if( issueId == NULL_ID )
     {
@@ -626,10 +848,38 @@ MainWindow::loadIssue( int issueId, bool startTimer, bool saveNewIssue )
         RETURN();
     }
 
+    auto issueLoaded = [=]( const Issue& issue )
+    {
+        ENTER()(issue);
+
+        issue_ = issueRegistry_->update( issue );
+
+        addRecentIssue( issue );
+        displayIssue( issue );
+
+        loadLatestActivity();
+        loadIssueStatuses();
+
+        if( startTimer )
+            start();
+
+        saveSettings();
+
+        RETURN();
+    };
+
+    // Display a cached issue at once and revalidate it in the background
+    bool cached = issueCache_.contains( issueId );
+    if( cached )
+        issueLoaded( issueCache_.issue(issueId) );
+
+    if( !connected() )
+        RETURN();
+
     ++callbackCounter_;
-    redmine_->retrieveIssue( [=]( Issue issue, RedmineError redmineError, QStringList errors )
+    redmine_->retrieveIssue( [=]( Issue issue, RedmineError redmineError, int status, QStringList errors )
     {
-        CBENTER()(issue)(redmineError)(errors);
+        CBENTER()(issue)(redmineError)(status)(errors);
 
         if( !connected() )
             CBRETURN();
@@ -641,75 +891,41 @@ MainWindow::loadIssue( int issueId, bool startTimer, bool saveNewIssue )
                 errorMsg.append("\n").append(error);
 
             message( errorMsg, QtCriticalMsg );
-            CBRETURN();
-        }
-
-        issue_ = issue;
 
-        addRecentIssue( issue );
-
-        qml("issueId")->setProperty( "text", QString("Issue ID: %1").arg(issue.id) );
-        qml("issueId")->setProperty( "cursorPosition", 0 );
-        qml("subject")->setProperty( "text", issue.subject );
-        qml("subject")->setProperty( "cursorPosition", 0 );
-        qml("description")->setProperty( "text", issue.description );
-
-        QString more;
-        if( issue.tracker.id != NULL_ID )
-            more.append( QString("<b>Tracker:</b> %1<br>").arg(issue.tracker.name) );
-        if( issue.category.id != NULL_ID )
-            more.append( QString("<b>Category:</b> %1<br>").arg(issue.category.name) );
-        if( issue.version.id != NULL_ID )
-            more.append( QString("<b>Target version:</b> %1<br>").arg(issue.version.name) );
-        if( issue.parentId != NULL_ID )
-            more.append( QString("<b>Parent issue ID:</b> %1<br>").arg(issue.parentId) );
-
-        QString customFields;
-        bool displayCustomFields = false;
-        for( const auto& customField : issue.customFields )
-        {
-            if( !customField.values.size()
-                || (customField.values.size() == 1 && customField.values[0].isEmpty()) )
-                continue;
+            // Only remove issues that have been deleted or are no longer visible to the user, not those that
+            // could not be loaded because of a network, server or authentication error
+            if( status != HTTP_NOT_FOUND && status != HTTP_FORBIDDEN )
+                CBRETURN();
 
-            displayCustomFields = true;
+            DEBUG() << "Issue is no longer accessible, removing it from the cache";
 
-            QString value;
+            issueCache_.remove( issueId );
 
-            for( const auto& val : customField.values )
+            // Tracked time is saved to the current issue, so keep it while there is any
+            if( issue_->id == issueId && !engine_.isRunning() && counter() == 0 )
             {
-                if( !value.isEmpty() )
-                    value.append( ", " );
-
-                value.append( val );
+                issue_ = IssueRegistry::null();
+                resetGui();
             }
 
-            customFields.append( QString("<b>%1:</b> %2<br>").arg(customField.name).arg(value) );
+            CBRETURN();
         }
-        if( displayCustomFields )
-            more.append( customFields );
 
-        if( more.isEmpty() )
-        {
-            qml("more")->setProperty( "visible", false );
-        }
-        else
+        bool changed = issueCache_.insert( issue );
+
+        if( !cached )
         {
-            // Remove the last <br>
-            more.chop(4);
-            qml("more")->setProperty( "text", more );
-            qml("more")->setProperty( "visible", true );
+            issueLoaded( issue );
+            CBRETURN();
         }
 
-        loadLatestActivity();
-        loadIssueStatuses();
-
-        updateTitle();
+        // The registry notifies all views if the issue has changed
+        if( !changed )
+            CBRETURN();
 
-        if( startTimer )
-            start();
+        DEBUG() << "Cached issue has changed, updating the registry";
 
-        saveSettings();
+        issueRegistry_->update( issue );
 
         CBRETURN();
     },
@@ -727,8 +943,8 @@ MainWindow::loadIssueStatuses()
         RETURN();
 
     ++callbackCounter_;
-    redmine_->retrieveIssueStatuses( [&]( IssueStatuses issueStatuses, RedmineError redmineError,
-                                          QStringList errors )
+    metadataCache_->retrieveIssueStatuses( [&]( IssueStatuses issueStatuses, RedmineError redmineError,
+                                                QStringList errors )
     {
         CBENTER()(redmineError)(errors);
 
@@ -747,17 +963,19 @@ MainWindow::loadIssueStatuses()
 
         int currentIndex = 0;
 
-        issueStatusModel_.clear();
-        issueStatusModel_.push_back( SimpleItem(NULL_ID, "Choose issue status") );
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose issue status") );
         for( const auto& issueStatus : issueStatuses )
         {
-            if( issueStatus.id == issue_.status.id )
-                currentIndex = issueStatusModel_.rowCount();
+            if( issueStatus.id == issue_->status.id )
+                currentIndex = items.size();
 
-            issueStatusModel_.push_back( SimpleItem(issueStatus) );
+            items.push_back( SimpleItem(issueStatus) );
         }
 
-        DEBUG()(issueStatusModel_)(issue_.status.id)(currentIndex);
+        issueStatusModel_.reset( items );
+
+        DEBUG()(issueStatusModel_)(issue_->status.id)(currentIndex);
 
         qml("issueStatus")->setProperty( "currentIndex", -1 );
         qml("issueStatus")->setProperty( "currentIndex", currentIndex );
@@ -776,7 +994,7 @@ MainWindow::loadLatestActivity()
     if( !connected() )
         RETURN();
 
-    if( issue_.id == NULL_ID )
+    if( issue_->id == NULL_ID )
     {
         loadActivities();
         RETURN();
@@ -808,7 +1026,7 @@ MainWindow::loadLatestActivity()
 
         CBRETURN();
     },
-    QString("issue_id=%1&limit=1").arg(issue_.id) );
+    QString("issue_id=%1&limit=1").arg(issue_->id) );
 
     RETURN();
 }
@@ -910,7 +1128,7 @@ MainWindow::loadOrCreateIssue( CliOptions options )
             {
                 // Search by issue ID
                 ++callbackCounter_;
-                redmine_->retrieveIssue( [=]( Issue issue, RedmineError redmineError, QStringList errors )
+                redmine_->retrieveIssue( [=]( Issue issue, RedmineError redmineError, int, QStringList errors )
                 {
                     CBENTER()(issue)(redmineError)(errors);
 
@@ -1028,6 +1246,46 @@ MainWindow::loadOrCreateIssue( CliOptions options )
     RETURN();
 }
 
+IssueSelector*
+MainWindow::issueSelector()
+{
+    ENTER();
+
+    if( issueSelector_ )
+        RETURN( issueSelector_ );
+
+    // Issue selector initialisation
+    issueSelector_ = new IssueSelector( this );
+    issueSelector_->setTransientParent( this );
+
+    // Connect the issue selected signal to the setIssue slot
+    connect( issueSelector_, &IssueSelector::selected, [=](int issueId)
+    {
+        ENTER()(issueId);
+
+        profileData()->projectId = issueSelector_->getProjectId();
+        loadIssue( issueId );
+
+        RETURN();
+    } );
+
+    RETURN( issueSelector_ );
+}
+
+IssueRegistry*
+MainWindow::issueRegistry()
+{
+    ENTER();
+    RETURN( issueRegistry_ );
+}
+
+MetadataCache*
+MainWindow::metadataCache()
+{
+    ENTER();
+    RETURN( metadataCache_ );
+}
+
 void
 MainWindow::notifyConnectionStatus( QNetworkAccessManager::NetworkAccessibility connected )
 {
@@ -1044,8 +1302,11 @@ MainWindow::notifyConnectionStatus( QNetworkAccessManager::NetworkAccessibility
         qml("connectionStatus")->setProperty("tooltip", "Connection established" );
         qml("connectionStatusStyle")->setProperty("color", "lightgreen" );
 
-        if( !timer_->isActive() && counterGui() != 0 )
-            stop( false );
+        if( !engine_.isRunning() && counterGui() != 0 )
+            stop();
+
+        // Send time entries and issue updates that have been recorded in the meantime
+        journal_->replay();
     }
     else
     {
@@ -1064,6 +1325,7 @@ MainWindow::pauseCounterGui()
     ENTER();
 
     updateCounterGui_ = false;
+    updateCounterTimer();
 
     // Save the currently displayed time
     QTime time = SimpleRedmineClient::getTime( qml("counter")->property("text").toString() );
@@ -1096,7 +1358,7 @@ MainWindow::receiveCommand()
         else if( options.command == "create" )
             loadOrCreateIssue( options );
         else if( options.command == "issue" )
-            options.issueId = issue_.id;
+            options.issueId = issue_->id;
 
         QByteArray block = CliOptions::serialise( options );
 
@@ -1120,22 +1382,30 @@ MainWindow::resumeCounterGui()
 
     if( time.isValid() )
     {
-        if( !timer_->isActive() )
+        if( !engine_.isRunning() )
             startTimer();
 
         int secs = time.hour()*3600 + time.minute()*60 + time.second();
 
         if( secs != counterBeforeEdit_ )
-            counterDiff_ = secs - counterNoDiff();
+            engine_.setElapsed( secs * 1000 );
     }
     else
         message( tr("Invalid time format, expecting hh:mm:ss "), QtCriticalMsg );
 
     updateCounterGui_ = true;
+    updateCounterTimer();
 
     RETURN();
 }
 
+RedmineSession*
+MainWindow::redmine()
+{
+    ENTER();
+    RETURN( redmine_ );
+}
+
 void
 MainWindow::reconnect()
 {
@@ -1158,6 +1428,9 @@ MainWindow::reconnectAndRefreshGui()
 {
     ENTER();
 
+    // Explicit reload: revalidate cached enumerations
+    metadataCache_->invalidate();
+
     reconnect();
     refreshGui();
 
@@ -1171,6 +1444,17 @@ MainWindow::refreshGui()
 
     const ProfileData* data = profileData();
 
+    issueCache_.open( data->id, data->url );
+    metadataCache_->open( data->id, data->url );
+    journal_->open( data->id, data->url );
+
+    // Paint the last rendered state at once and reconcile it with Redmine in the background
+    if( !initialised_ )
+    {
+        uiSnapshot_.open( data->id, data->url );
+        restoreSnapshot();
+    }
+
     redmine_->setCheckSsl( !data->ignoreSslErrors );
 
     shortcutCreateIssue_->setShortcut( QKeySequence(data->shortcutCreateIssue) );
@@ -1185,16 +1469,29 @@ MainWindow::refreshGui()
 
     loadIssue( data->issueId, false, true );
 
-    recentIssues_.clear();
-    for( const auto& issue : data->recentIssues )
-        recentIssues_.push_back( issue );
+    // Only the IDs and subjects of the recent issues are saved, so prefer the cached issues
+    Issues recentIssues;
+    for( const auto& item : data->recentIssues )
+    {
+        if( issueCache_.contains(item.id) )
+        {
+            recentIssues.append( issueCache_.issue(item.id) );
+            continue;
+        }
+
+        Issue issue;
+        issue.id = item.id;
+        issue.subject = item.name;
+        recentIssues.append( issue );
+    }
+    recentIssues_.reset( recentIssues );
 
     loadLatestActivity();
     loadIssueStatuses();
 
     updateTitle();
 
-    if( !timer_->isActive() && counter() != 0 )
+    if( !engine_.isRunning() && counter() != 0 )
         stop();
 
     RETURN();
@@ -1223,6 +1520,80 @@ MainWindow::resetGui( const QString value )
     RETURN();
 }
 
+void
+MainWindow::restoreSnapshot()
+{
+    ENTER();
+
+    if( uiSnapshot_.isEmpty() )
+        RETURN();
+
+    const UiSnapshot& snapshot = uiSnapshot_;
+
+    // Only display the issue if it is still the current one
+    if( snapshot.issue.id != NULL_ID && snapshot.issue.id == profileData()->issueId )
+    {
+        issue_ = issueRegistry_->update( snapshot.issue );
+        displayIssue( *issue_ );
+    }
+
+    auto restoreModel = [=]( SimpleModel& model, const QList<Item>& items, int index, const char* qmlItem )
+    {
+        QList<SimpleItem> simpleItems;
+        for( const auto& item : items )
+            simpleItems.push_back( SimpleItem(item) );
+
+        model.reset( simpleItems );
+
+        if( index < 0 || index >= simpleItems.size() )
+            index = 0;
+
+        qml(qmlItem)->setProperty( "currentIndex", -1 );
+        qml(qmlItem)->setProperty( "currentIndex", index );
+    };
+
+    restoreModel( activityModel_, snapshot.activities, snapshot.activityIndex, "activity" );
+    restoreModel( issueStatusModel_, snapshot.issueStatuses, snapshot.issueStatusIndex, "issueStatus" );
+
+    // Keep the selected activity when the activities are reloaded
+    int activityIndex = qml("activity")->property("currentIndex").toInt();
+    if( activityId_ == NULL_ID && activityIndex > 0 )
+        activityId_ = activityModel_.at(activityIndex).id();
+
+    DEBUG()(issue_->id)(activityModel_)(issueStatusModel_);
+
+    RETURN();
+}
+
+void
+MainWindow::saveSnapshot()
+{
+    ENTER();
+
+    auto saveModel = [=]( const SimpleModel& model, QList<Item>& items )
+    {
+        items.clear();
+        for( const auto& simpleItem : model.data() )
+        {
+            Item item;
+            item.id = simpleItem.id();
+            item.name = simpleItem.name();
+            items.push_back( item );
+        }
+    };
+
+    uiSnapshot_.issue = *issue_;
+    saveModel( activityModel_, uiSnapshot_.activities );
+    uiSnapshot_.activityIndex = qml("activity")->property("currentIndex").toInt();
+    saveModel( issueStatusModel_, uiSnapshot_.issueStatuses );
+    uiSnapshot_.issueStatusIndex = qml("issueStatus")->property("currentIndex").toInt();
+
+    if( !uiSnapshot_.save() )
+        DEBUG() << "Could not save the UI snapshot";
+
+    RETURN();
+}
+
 void
 MainWindow::saveSettings()
 {
@@ -1230,13 +1601,22 @@ MainWindow::saveSettings()
 
     ProfileData* data = profileData();
     settings_->windowData()->mainWindow = getWindowData();
-    data->recentIssues = recentIssues_.data().toVector();
+
+    // Only the IDs and subjects of the recent issues are saved
+    data->recentIssues.clear();
+    for( int row = 0; row < recentIssues_.rowCount(); ++row )
+    {
+        Item item;
+        item.id = recentIssues_.idAt( row );
+        item.name = recentIssues_.subjectAt( row );
+        data->recentIssues.append( item );
+    }
 
     // If currently there is no issue selected, use the first one from the recently opened issues list
-    if( issue_.id == NULL_ID && recentIssues_.rowCount() )
-        data->issueId = recentIssues_.at(0).id;
+    if( issue_->id == NULL_ID && recentIssues_.rowCount() )
+        data->issueId = recentIssues_.idAt(0);
     else
-        data->issueId = issue_.id;
+        data->issueId = issue_->id;
 
     settings_->save();
 
@@ -1248,8 +1628,8 @@ MainWindow::selectIssue()
 {
     ENTER();
 
-    issueSelector_->setProjectId( profileData()->projectId );
-    issueSelector_->display();
+    issueSelector()->setProjectId( profileData()->projectId );
+    issueSelector()->display();
 
     RETURN();
 }
@@ -1260,7 +1640,7 @@ MainWindow::start()
     ENTER();
 
     // If no issue is selected, show issue selector
-    if( issue_.id == NULL_ID )
+    if( issue_->id == NULL_ID )
     {
         // Make sure that the main window is visible
         display();
@@ -1288,7 +1668,13 @@ MainWindow::settingsApplied()
         RETURN();
     }
 
-    reconnect();
+    // Switch the shared session to the applied login
+    const ProfileData* data = profileData();
+    redmine_->setCheckSsl( !data->ignoreSslErrors );
+    redmine_->setUrl( data->url );
+    redmine_->setAuthenticator( data->apiKey );
+    redmine_->reconnect();
+
     refreshGui();
 
     RETURN();
@@ -1300,8 +1686,8 @@ MainWindow::startStop()
     ENTER();
 
     // If the timer is currently active, stop it; otherwise, start it
-    if( timer_->isActive() )
-        stop( false );
+    if( engine_.isRunning() )
+        stop();
     else
         start();
 
@@ -1313,11 +1699,11 @@ MainWindow::startTimer()
 {
     ENTER();
 
-    timer_->start();
-
-    lastCounterUpdated_ = QDateTime::currentDateTimeUtc();
+    engine_.start();
     lastStarted_ = QDateTime::currentDateTimeUtc();
 
+    updateCounterTimer();
+
     // Set the start/stop button icon to stop
     qml("startStop")->setProperty( "iconSource", "qrc:/open-iconic/svg/media-stop.svg" );
     qml("startStop")->setProperty( "tooltip", tr("Stop time tracking") );
@@ -1327,22 +1713,18 @@ MainWindow::startTimer()
 
     // Set the issue status ID to the worked on ID if not already done
     int workedOnId = profileData()->workedOnId;
-    if( workedOnId != NULL_ID && workedOnId != issue_.status.id )
+    if( workedOnId != NULL_ID && workedOnId != issue_->status.id )
         updateIssueStatus( workedOnId );
 
     RETURN();
 }
 
 void
-MainWindow::stop( bool resetTimerOnError, bool stopTimerAfterSaving, SuccessCb cb )
+MainWindow::stop( bool stopTimerAfterSaving, SuccessCb cb )
 {
     ENTER();
 
-    QDateTime cur = QDateTime::currentDateTimeUtc();
-    counterDiff_ += lastCounterUpdated_.secsTo( cur );
-    lastCounterUpdated_ = cur;
-
-    if( !timer_->isActive() && counterGui() == 0 )
+    if( !engine_.isRunning() && counterGui() == 0 )
     {
         if( cb )
             cb( true, NULL_ID, (RedmineError)RedmineError::NO_ERR, QStringList() );
@@ -1367,8 +1749,9 @@ MainWindow::stop( bool resetTimerOnError, bool stopTimerAfterSaving, SuccessCb c
     TimeEntry timeEntry;
     timeEntry.activity.id = activityId_;
     timeEntry.hours       = counter() / 3600; // Seconds to hours conversion
-    timeEntry.issue.id    = issue_.id;
+    timeEntry.issue.id    = issue_->id;
     timeEntry.comment     = qml("entryComment")->property("text").toString();  // Time entry comment
+    timeEntry.spentOn     = QDate::currentDate(); // The entry might be sent on another day
 
     // Possibly save start and end time as well
     const ProfileData* data = profileData();
@@ -1399,47 +1782,39 @@ MainWindow::stop( bool resetTimerOnError, bool stopTimerAfterSaving, SuccessCb c
     // Stop the timer for now - might be started again later
     stopTimer();
 
-    ++callbackCounter_;
-    redmine_->sendTimeEntry( timeEntry, [=](bool success, int id, RedmineError errorCode, QStringList errors)
+    // Write the time entry to the journal first; it is sent to Redmine in the background
+    int seconds = counter();
+    if( !journal_->appendTimeEntry(timeEntry) )
     {
-        CBENTER()(success)(id)(errorCode)(errors);
-
-        if( !success && errorCode != RedmineError::ERR_TIME_ENTRY_TOO_SHORT )
-        {
-            QString errorMsg = tr( "Could not save the time entry." );
-            for( const auto& error : errors )
-                errorMsg.append("\n").append(error);
-            message( errorMsg, QtCriticalMsg );
-
-            if( cb )
-                cb( success, id, errorCode, errors );
+        QStringList errors;
+        errors.append( tr("Could not save the time entry to the local journal.") );
+        message( errors.at(0), QtCriticalMsg );
 
-            CBRETURN();
-        }
+        if( cb )
+            cb( false, NULL_ID, RedmineError::ERR_NOT_SAVED, errors );
 
-        if( errorCode == RedmineError::ERR_TIME_ENTRY_TOO_SHORT && stopTimerAfterSaving )
-            message( tr("Not saving too short time entries."), QtWarningMsg );
+        RETURN();
+    }
 
-        if( !stopTimerAfterSaving )
-            startTimer();
+    if( !stopTimerAfterSaving )
+        startTimer();
 
-        if( success )
-            message( tr("Saved time %1").arg(QTime(0, 0, 0).addSecs(counter()).toString("HH:mm:ss")) );
+    QString savedMsg = tr("Saved time %1").arg( QTime(0, 0, 0).addSecs(seconds).toString("HH:mm:ss") );
+    if( engine_.suspended() )
+        savedMsg.append( tr(", not counting %1 minutes of suspend").arg(engine_.suspended() / 60000) );
+    message( savedMsg );
 
-        if( success || (resetTimerOnError && errorCode != RedmineError::ERR_TIME_ENTRY_TOO_SHORT) )
-        {
-            counterDiff_ = 0;
-            qmlCounter_->setProperty( "text", "00:00:00" );
-        }
+    engine_.reset();
+    qmlCounter_->setProperty( "text", "00:00:00" );
 
-        DEBUG() << "Emitting signal timeEntrySaved()";
-        emit timeEntrySaved();
+    if( connected() )
+        journal_->replay();
 
-        if( cb )
-            cb( true, id, errorCode, errors );
+    DEBUG() << "Emitting signal timeEntrySaved()";
+    emit timeEntrySaved();
 
-        CBRETURN();
-    });
+    if( cb )
+        cb( true, NULL_ID, RedmineError::NO_ERR, QStringList() );
 
     RETURN();
 }
@@ -1449,7 +1824,8 @@ MainWindow::stopTimer()
 {
     ENTER();
 
-    timer_->stop();
+    engine_.stop();
+    updateCounterTimer();
 
     // Set the start/stop button icon to start
     qml("startStop")->setProperty( "iconSource", "qrc:///open-iconic/svg/media-play.svg" );
@@ -1495,41 +1871,46 @@ MainWindow::trayIcon()
 }
 
 void
-MainWindow::updateIssueStatus( int statusId )
+MainWindow::updateCounterTimer()
 {
-    ENTER();
+    ENTER()(engine_.isRunning())(updateCounterGui_)(hidden_)(isExposed());
 
-    if( statusId == NULL_ID || issue_.id == NULL_ID )
+    if( !engine_.isRunning() || !updateCounterGui_ || hidden_ || !isExposed() )
+    {
+        timer_->stop();
         RETURN();
+    }
 
-    Issue issue;
-    issue.status.id = statusId;
+    refreshCounter();
 
-    ++callbackCounter_;
-    redmine_->sendIssue( issue, [=](bool success, int id, RedmineError errorCode, QStringList errors)
-    {
-        CBENTER();
+    if( !timer_->isActive() )
+        timer_->start();
 
-        DEBUG()(success)(id)(errorCode)(errors);
+    RETURN();
+}
 
-        if( !success )
-        {
-            QString errorMsg = tr( "Could not update the issue." );
-            for( const auto& error : errors )
-                errorMsg.append("\n").append(error);
+void
+MainWindow::updateIssueStatus( int statusId )
+{
+    ENTER();
 
-            message( errorMsg, QtCriticalMsg );
-            CBRETURN();
-        }
+    if( statusId == NULL_ID || issue_->id == NULL_ID )
+        RETURN();
 
-        message( tr("Issue updated") );
+    if( !journal_->appendIssueStatus(issue_->id, statusId) )
+    {
+        message( tr("Could not save the issue update to the local journal."), QtCriticalMsg );
+        RETURN();
+    }
 
-        issue_.status.id = statusId;
-        loadIssueStatuses();
+    // Show the new status at once, also when the issue is loaded from the cache later on
+    Issue issue = *issue_;
+    issue.status.id = statusId;
+    issueCache_.insertUnconfirmed( issue );
+    issueRegistry_->update( issue );
 
-        CBRETURN();
-    },
-    issue_.id );
+    if( connected() )
+        journal_->replay();
 
     RETURN();
 }
@@ -1544,11 +1925,11 @@ MainWindow::updateTitle()
 
     if( trayIcon_ )
     {
-        if( issue_.id != NULL_ID )
+        if( issue_->id != NULL_ID )
         {
-            title.append( QString("\n\nIssue ID: %1").arg(issue_.id) );
-            if( !issue_.subject.isEmpty() )
-                title.append( QString("\n%2").arg(issue_.subject) );
+            title.append( QString("\n\nIssue ID: %1").arg(issue_->id) );
+            if( !issue_->subject.isEmpty() )
+                title.append( QString("\n%2").arg(issue_->subject) );
         }
         trayIcon_->setToolTip( title );
     }
@@ -5,6 +5,13 @@
 
 #include "qtredmine/SimpleRedmineClient.h"
 #include "redtimer/CliOptions.h"
+#include "redtimer/IssueCache.h"
+#include "redtimer/IssueRegistry.h"
+#include "redtimer/MetadataCache.h"
+#include "redtimer/RedmineSession.h"
+#include "redtimer/TimeEntryJournal.h"
+#include "redtimer/TimerEngine.h"
+#include "redtimer/UiSnapshot.h"
 #include "qxtglobalshortcut.h"
 
 #include <QApplication>
@@ -53,8 +60,20 @@ class MainWindow : public Window
     Q_OBJECT
 
 private:
-    /// Redmine connection object
-    qtredmine::SimpleRedmineClient* redmine_ = nullptr;
+    /// Cache for mostly static Redmine enumerations
+    MetadataCache* metadataCache_ = nullptr;
+
+    /// Canonical issues shared by all windows
+    IssueRegistry* issueRegistry_ = nullptr;
+
+    /// Maximum time in milliseconds to wait for journaled entries to be sent on exit
+    static const int EXIT_TIMEOUT = 1000;
+
+    /// Maximum time in milliseconds to wait for journaled entries to be sent before switching the login
+    static const int DRAIN_TIMEOUT = 5000;
+
+    /// Write-ahead journal of time entries and issue updates
+    TimeEntryJournal* journal_ = nullptr;
 
     /// Main application
     QApplication* app_ = nullptr;
@@ -64,8 +83,11 @@ private:
     ProcessSerialNumber psn_ = { 0, kCurrentProcess };
 #endif
 
-    /// Issue Selector
-    IssueSelector* issueSelector_;
+    /// Delay in milliseconds after startup until secondary windows are prepared
+    static const int IDLE_DELAY = 3000;
+
+    /// Issue Selector, created upon first use
+    IssueSelector* issueSelector_ = nullptr;
 
     /// Shortcuts
     QxtGlobalShortcut* shortcutCreateIssue_;
@@ -82,7 +104,10 @@ private:
     /// System tray icon
     QSystemTrayIcon* trayIcon_ = nullptr;
 
-    /// Timer for stopping the worked on time
+    /// Time tracking engine
+    TimerEngine engine_;
+
+    /// Timer for refreshing the displayed counter, only active while the counter is visible
     QTimer* timer_ = nullptr;
 
     /// Server for local socket connection
@@ -94,9 +119,6 @@ private:
     /// Currently connected
     bool connected_ = false;
 
-    /// Add this time in seconds to the tracked time (may be negative)
-    int counterDiff_ = 0;
-
     /// Displayed tracked time when the counter was paused to edit the time
     int counterBeforeEdit_ = 0;
 
@@ -110,7 +132,10 @@ private:
     SimpleModel activityModel_;
 
     /// Current issue
-    qtredmine::Issue issue_;
+    IssueHandle issue_ = IssueRegistry::null();
+
+    /// Persistent cache of recently loaded issues
+    IssueCache issueCache_;
 
     /// Cached issue statuses
     SimpleModel issueStatusModel_;
@@ -118,8 +143,8 @@ private:
     /// Recently opened issues
     IssueModel recentIssues_;
 
-    /// Last time that the counter diff has been updated, in UTC
-    QDateTime lastCounterUpdated_;
+    /// Last rendered state, displayed upon startup until the data has been reloaded
+    UiSnapshot uiSnapshot_;
 
     /// Last time that the timer has been started, in UTC
     QDateTime lastStarted_;
@@ -141,9 +166,9 @@ private:
     void addRecentIssue( qtredmine::Issue issue );
 
     /**
-     * @brief Get the currently tracked time including the difference
+     * @brief Get the currently tracked time
      *
-     * @return Currently tracked time including the difference in seconds
+     * @return Currently tracked time in seconds
      */
     double counter();
 
@@ -155,11 +180,28 @@ private:
     double counterGui();
 
     /**
-     * @brief Get the currently tracked time without the difference
+     * @brief Display the issue data in the GUI
      *
-     * @return Currently tracked time in seconds
+     * @param issue Issue to display
      */
-    double counterNoDiff();
+    void displayIssue( const qtredmine::Issue& issue );
+
+    /**
+     * @brief Get the issue selector, creating it if necessary
+     *
+     * @return Issue selector
+     */
+    IssueSelector* issueSelector();
+
+    /**
+     * @brief Display the last rendered state from the UI snapshot
+     */
+    void restoreSnapshot();
+
+    /**
+     * @brief Save the currently rendered state to the UI snapshot
+     */
+    void saveSnapshot();
 
     /**
      * @brief Start the timer
@@ -171,6 +213,15 @@ private:
      */
     void stopTimer();
 
+    /**
+     * @brief Start or stop refreshing the displayed counter
+     *
+     * The counter is only refreshed while time is being tracked and the counter is visible, so that there
+     * are no wakeups while the main window is hidden or minimised. Upon becoming visible, the counter is
+     * recomputed at once.
+     */
+    void updateCounterTimer();
+
 public:
     /**
      * @brief RedTimer constructor
@@ -187,6 +238,16 @@ public:
      */
     bool connected();
 
+    /**
+     * @brief Wait until the journaled entries have been sent to Redmine
+     *
+     * Waits at most DRAIN_TIMEOUT milliseconds. Does not wait if the journal is empty or if there is no
+     * connection; the remaining entries are sent once the journal is replayed again.
+     *
+     * @param cb Callback function, called exactly once
+     */
+    void drainJournal( std::function<void()> cb );
+
     /**
      * @brief Determines whether the main window is currently hidden
      *
@@ -199,6 +260,27 @@ public:
      */
     void initTrayIcon();
 
+    /**
+     * @brief Get the issue registry
+     *
+     * @return Issue registry
+     */
+    IssueRegistry* issueRegistry();
+
+    /**
+     * @brief Get the metadata cache
+     *
+     * @return Metadata cache
+     */
+    MetadataCache* metadataCache();
+
+    /**
+     * @brief Get the Redmine session shared by all windows
+     *
+     * @return Redmine session
+     */
+    RedmineSession* redmine();
+
     /**
      * @brief Save the current configuration
      */
@@ -375,7 +457,7 @@ private slots:
      * Starts time tracking using the timer. If the timer is already active, the previously tracked time will
      * be saved first and the the new time tracking will be started. Requires the current issue to be set.
      *
-     * \sa timer_
+     * \sa engine_
      * \sa issue_
      */
     void start();
@@ -386,7 +468,7 @@ private slots:
      * Start time tracking if the timer is currently inactive. Stop time tracking if the timer is currently
      * active.
      *
-     * \sa timer_
+     * \sa engine_
      */
     void startStop();
 
@@ -420,22 +502,24 @@ public slots:
      *
      * If the timer is running, a warning is displayed which gives the user the opportunity to abort exiting,
      * to save the tracked time or to discard the tracked time.
+     *
+     * Saved time is written to the local journal. Exiting waits at most EXIT_TIMEOUT milliseconds for
+     * journaled entries to be sent to Redmine; the remaining entries are sent upon the next start.
      */
     void exit();
 
     /**
      * @brief Stop time tracking
      *
-     * Stops time tracking using the timer.
+     * Stops time tracking using the timer. The tracked time is written to the local journal and sent to
+     * Redmine in the background, i.e. stopping never waits for the network.
      *
-     * @param resetTimerOnError Reset timer even after an error occurred
      * @param stopTimerAfterSaving Stop the timer after saving the time and resetting the counter
      * @param cb Success callback
      *
-     * \sa timer_
+     * \sa engine_
      */
-    void stop( bool resetTimerOnError = true, bool stopTimerAfterSaving = true,
-               qtredmine::SuccessCb cb = nullptr );
+    void stop( bool stopTimerAfterSaving = true, qtredmine::SuccessCb cb = nullptr );
 
 signals:
     /**
@@ -35,6 +35,32 @@ IssueModel::IssueModel( QObject* parent )
     : QAbstractListModel( parent )
 {}
 
+void
+IssueModel::append( const IssueStore::Block& block )
+{
+    ENTER()(block.size());
+
+    if( block.size() == 0 )
+        RETURN();
+
+    int row = rowCount();
+
+    beginInsertRows( QModelIndex(), row, row + block.size() - 1 );
+    items_.append( block );
+    reindex( row );
+    endInsertRows();
+
+    RETURN();
+}
+
+void
+IssueModel::append( const Issues& items )
+{
+    ENTER()(items.size());
+    append( IssueStore::encode(items) );
+    RETURN();
+}
+
 Issue
 IssueModel::at( const int index ) const
 {
@@ -42,6 +68,20 @@ IssueModel::at( const int index ) const
     RETURN( items_.at(index) );
 }
 
+int
+IssueModel::idAt( const int index ) const
+{
+    ENTER()(index);
+    RETURN( items_.id(index) );
+}
+
+QString
+IssueModel::subjectAt( const int index ) const
+{
+    ENTER()(index);
+    RETURN( items_.subject(index) );
+}
+
 void
 IssueModel::clear()
 {
@@ -52,18 +92,29 @@ IssueModel::clear()
 
     beginRemoveRows( QModelIndex(), 0, rowCount()-1 );
     items_.clear();
+    rows_.clear();
+    first_ = 0;
     endRemoveRows();
 
     RETURN();
 }
 
+int
+IssueModel::indexOf( int issueId ) const
+{
+    ENTER()(issueId);
+    auto it = rows_.constFind( issueId );
+    RETURN( it == rows_.constEnd() ? -1 : it.value() - first_ );
+}
+
 void
 IssueModel::push_back( const Issue& item )
 {
     ENTER()(item);
 
     beginInsertRows( QModelIndex(), rowCount(), rowCount() );
-    items_.push_back( item );
+    items_.append( Issues{item} );
+    rows_.insert( item.id, first_ + items_.size() - 1 );
     endInsertRows();
 
     RETURN();
@@ -75,12 +126,20 @@ IssueModel::push_front( const Issue& item )
     ENTER()(item);
 
     beginInsertRows( QModelIndex(), 0, 0 );
-    items_.push_front( item );
+    items_.insert( 0, Issues{item} );
+    rows_.insert( item.id, --first_ );
     endInsertRows();
 
     RETURN();
 }
 
+void
+IssueModel::reindex( int row )
+{
+    for( int i = row; i < items_.size(); ++i )
+        rows_.insert( items_.id(i), first_ + i );
+}
+
 bool
 IssueModel::removeRows( int begin, int count, const QModelIndex& parent )
 {
@@ -88,12 +147,30 @@ IssueModel::removeRows( int begin, int count, const QModelIndex& parent )
 
     ENTER()(begin)(count)(end);
 
-    if( end >= rowCount() )
+    if( begin < 0 || count <= 0 || end >= rowCount() )
         RETURN( false );
 
     beginRemoveRows( parent, begin, end );
+
     for( int i = begin; i <= end; ++i )
-        items_.removeAt( i );
+        rows_.remove( items_.id(i) );
+
+    // Move the rows in front of the removed ones towards them if there are fewer of those than behind them
+    if( begin < rowCount() - 1 - end )
+    {
+        for( int i = 0; i < begin; ++i )
+            rows_[items_.id(i)] += count;
+
+        first_ += count;
+    }
+    else
+    {
+        for( int i = end + 1; i < rowCount(); ++i )
+            rows_[items_.id(i)] -= count;
+    }
+
+    items_.remove( begin, count );
+
     endRemoveRows();
 
     RETURN( true );
@@ -114,11 +191,50 @@ IssueModel::removeRowsFrom( int row )
     RETURN( removeRows(row, count) );
 }
 
+void
+IssueModel::reset( const IssueStore::Block& block )
+{
+    ENTER()(block.size());
+
+    beginResetModel();
+    items_.clear();
+    items_.append( block );
+    rows_.clear();
+    first_ = 0;
+    reindex();
+    endResetModel();
+
+    RETURN();
+}
+
+void
+IssueModel::reset( const Issues& items )
+{
+    ENTER()(items.size());
+    reset( IssueStore::encode(items) );
+    RETURN();
+}
+
+bool
+IssueModel::update( const Issue& item )
+{
+    ENTER()(item.id);
+
+    int row = indexOf( item.id );
+    if( row == -1 )
+        RETURN( false );
+
+    items_.replace( row, item );
+    emit dataChanged( index(row), index(row) );
+
+    RETURN( true );
+}
+
 int
 IssueModel::rowCount( const QModelIndex& parent ) const
 {
     Q_UNUSED( parent );
-    return items_.count();
+    return items_.size();
 }
 
 QVariant
@@ -126,56 +242,56 @@ IssueModel::data( const QModelIndex& index, int role ) const
 {
     ENTER()(index)(role);
 
-    if( index.row() < 0 || index.row() >= items_.count() )
-        RETURN( QVariant() );
+    int row = index.row();
 
-    const Issue& item = items_[index.row()];
+    if( row < 0 || row >= items_.size() )
+        RETURN( QVariant() );
 
     if( role == IdRole )
-        RETURN( item.id );
+        RETURN( items_.id(row) );
     else if( role == DescriptionRole )
-        RETURN( item.description );
+        RETURN( items_.description(row) );
     else if( role == DoneRatioRole )
-        RETURN( item.doneRatio );
+        RETURN( items_.doneRatio(row) );
     else if( role == SubjectRole )
-        RETURN( item.subject );
+        RETURN( items_.subject(row) );
     else if( role == AuthorRole )
-        RETURN( QVariant::fromValue(item.author) );
+        RETURN( QVariant::fromValue(items_.item(IssueStore::Author, row)) );
     else if( role == CategoryRole )
-        RETURN( QVariant::fromValue(item.category) );
+        RETURN( QVariant::fromValue(items_.item(IssueStore::Category, row)) );
     else if( role == PriorityRole )
-        RETURN( QVariant::fromValue(item.priority) );
+        RETURN( QVariant::fromValue(items_.item(IssueStore::Priority, row)) );
     else if( role == ProjectRole )
-        RETURN( QVariant::fromValue(item.project) );
+        RETURN( QVariant::fromValue(items_.item(IssueStore::Project, row)) );
     else if( role == StatusRole )
-        RETURN( QVariant::fromValue(item.status) );
+        RETURN( QVariant::fromValue(items_.item(IssueStore::Status, row)) );
     else if( role == TrackerRole )
-        RETURN( QVariant::fromValue(item.tracker) );
+        RETURN( QVariant::fromValue(items_.item(IssueStore::Tracker, row)) );
     else if( role == CreatedOnRole )
-        RETURN( item.createdOn );
+        RETURN( items_.createdOn(row) );
     else if( role == DueDateRole )
-        RETURN( item.dueDate );
+        RETURN( items_.dueDate(row) );
     else if( role == EstimatedHoursRole )
-        RETURN( item.estimatedHours );
+        RETURN( items_.estimatedHours(row) );
     else if( role == StartDateRole )
-        RETURN( item.startDate );
+        RETURN( items_.startDate(row) );
     else if( role == UpdatedOnRole )
-        RETURN( item.updatedOn );
+        RETURN( items_.updatedOn(row) );
     else if( role == CustomFieldsRole )
-        RETURN( QVariant::fromValue(item.customFields) );
+        RETURN( QVariant::fromValue(items_.customFields(row)) );
     else if( role == TextRole )
-        RETURN( QString("#%1: %2").arg(QString::number(item.id)).arg(item.subject) );
+        RETURN( items_.text(row) );
     else if( role == FindRole )
-        RETURN( QString("%1 %2").arg(item.subject).arg(item.description) );
+        RETURN( QString("%1 %2").arg(items_.subject(row)).arg(items_.description(row)) );
     else
         RETURN( QVariant() );
 }
 
-QList<Issue>
+Issues
 IssueModel::data() const
 {
     ENTER();
-    RETURN( items_ );
+    RETURN( items_.issues() );
 }
 
 
@@ -207,10 +323,87 @@ IssueModel::roleNames() const
     RETURN( roles );
 }
 
+IssueFilterModel::IssueFilterModel( QObject* parent )
+    : QSortFilterProxyModel( parent )
+{
+    // Stay sorted so that changing the matches only takes a single invalidation
+    sort( 0 );
+}
+
+void
+IssueFilterModel::clearMatches()
+{
+    ENTER();
+
+    if( !active_ )
+        RETURN();
+
+    active_ = false;
+    ranks_.clear();
+
+    invalidate();
+
+    RETURN();
+}
+
+bool
+IssueFilterModel::filterAcceptsRow( int sourceRow, const QModelIndex& sourceParent ) const
+{
+    if( !active_ )
+        return true;
+
+    QModelIndex index = sourceModel()->index( sourceRow, 0, sourceParent );
+    return ranks_.contains( index.data(IssueModel::IdRole).toInt() );
+}
+
+bool
+IssueFilterModel::lessThan( const QModelIndex& left, const QModelIndex& right ) const
+{
+    if( !active_ )
+        return left.row() < right.row();
+
+    int leftId = left.data( IssueModel::IdRole ).toInt();
+    int rightId = right.data( IssueModel::IdRole ).toInt();
+
+    return ranks_.value( leftId ) < ranks_.value( rightId );
+}
+
+void
+IssueFilterModel::setMatches( const QVector<int>& issueIds )
+{
+    ENTER()(issueIds.size());
+
+    ranks_.clear();
+    ranks_.reserve( issueIds.size() );
+    for( int i = 0; i < issueIds.size(); ++i )
+        ranks_.insert( issueIds[i], i );
+
+    active_ = true;
+
+    invalidate();
+
+    RETURN();
+}
+
 SimpleModel::SimpleModel( QObject* parent )
     : QAbstractListModel( parent )
 {}
 
+void
+SimpleModel::append( const QList<SimpleItem>& items )
+{
+    ENTER()(items.size());
+
+    if( items.isEmpty() )
+        RETURN();
+
+    beginInsertRows( QModelIndex(), rowCount(), rowCount() + items.size() - 1 );
+    items_.append( items );
+    endInsertRows();
+
+    RETURN();
+}
+
 void
 SimpleModel::push_back( const SimpleItem& item )
 {
@@ -285,17 +478,28 @@ SimpleModel::removeRows( int begin, int count, const QModelIndex& parent )
 
     ENTER()(begin)(count)(end);
 
-    if( end >= rowCount() )
+    if( begin < 0 || count <= 0 || end >= rowCount() )
         RETURN( false );
 
     beginRemoveRows( parent, begin, end );
-    for( int i = begin; i <= end; ++i )
-        items_.removeAt( i );
+    items_.erase( items_.begin() + begin, items_.begin() + end + 1 );
     endRemoveRows();
 
     RETURN( true );
 }
 
+void
+SimpleModel::reset( const QList<SimpleItem>& items )
+{
+    ENTER()(items.size());
+
+    beginResetModel();
+    items_ = items;
+    endResetModel();
+
+    RETURN();
+}
+
 QHash<int, QByteArray>
 SimpleModel::roleNames() const
 {
@@ -1,10 +1,14 @@
 #pragma once
 
 #include "qtredmine/SimpleRedmineClient.h"
+#include "redtimer/IssueStore.h"
 
 #include <QAbstractListModel>
+#include <QHash>
 #include <QObject>
+#include <QSortFilterProxyModel>
 #include <QString>
+#include <QVector>
 
 namespace redtimer {
 
@@ -74,14 +78,35 @@ public:
 
 /**
  * @brief Class that represents the model of an issue
+ *
+ * The issues are kept in a column-wise store, so that large issue lists take little memory and role
+ * accesses do not need to decode whole issues.
+ *
+ * Rows are looked up by issue ID in constant time. The row index is kept up to date incrementally: issues
+ * inserted in front or appended only add themselves, and removing rows only shifts the rows on the shorter
+ * side of the removed ones.
  */
 class IssueModel : public QAbstractListModel
 {
     Q_OBJECT
 
 private:
-    /// Internal issue cache
-    QList<qtredmine::Issue> items_;
+    /// Internal issue store
+    IssueStore items_;
+
+    /// Position of each issue by issue ID, the row of an issue is its position minus first_
+    QHash<int, int> rows_;
+
+    /// Position of the first row, decreased when an issue is inserted in front
+    int first_ = 0;
+
+private:
+    /**
+     * @brief Update the row index starting with the specified row
+     *
+     * @param row First row to update
+     */
+    void reindex( int row = 0 );
 
 public:
     /// Issue model roles
@@ -125,12 +150,39 @@ public:
      */
     qtredmine::Issue at( const int index ) const;
 
+    /**
+     * @brief Get the ID of the issue at the specified index
+     *
+     * @param index Index within the issue model
+     *
+     * @return The ID of the issue at the specified index
+     */
+    int idAt( const int index ) const;
+
+    /**
+     * @brief Get the subject of the issue at the specified index
+     *
+     * @param index Index within the issue model
+     *
+     * @return The subject of the issue at the specified index
+     */
+    QString subjectAt( const int index ) const;
+
     /**
      * @brief Get all issues from the model
      *
      * @return A list of all issues in the model
      */
-    QList<qtredmine::Issue> data() const;
+    qtredmine::Issues data() const;
+
+    /**
+     * @brief Get the row of an issue
+     *
+     * @param issueId Issue ID
+     *
+     * @return Row of the issue or -1 if the issue is not in the model
+     */
+    int indexOf( int issueId ) const;
 
     /**
      * @brief Get the row count
@@ -151,6 +203,24 @@ public:
      */
     void clear();
 
+    /**
+     * @brief Append encoded issues to the end of the model
+     *
+     * Emits a single row insertion for all issues.
+     *
+     * @param block Encoded issues to append
+     */
+    void append( const IssueStore::Block& block );
+
+    /**
+     * @brief Append issues to the end of the model
+     *
+     * Emits a single row insertion for all issues.
+     *
+     * @param items Issues to append
+     */
+    void append( const qtredmine::Issues& items );
+
     /**
      * @brief Append an issue to the end of the model
      *
@@ -185,6 +255,35 @@ public:
      */
     bool removeRowsFrom( int row );
 
+    /**
+     * @brief Replace the contents of the model with encoded issues
+     *
+     * Emits a single model reset.
+     *
+     * @param block New encoded issues
+     */
+    void reset( const IssueStore::Block& block );
+
+    /**
+     * @brief Replace the contents of the model
+     *
+     * Emits a single model reset.
+     *
+     * @param items New issues
+     */
+    void reset( const qtredmine::Issues& items );
+
+    /**
+     * @brief Replace an issue in place
+     *
+     * Does nothing if the issue is not in the model.
+     *
+     * @param item Updated issue
+     *
+     * @return True if the issue has been updated, false otherwise
+     */
+    bool update( const qtredmine::Issue& item );
+
     /// @}
 
 protected:
@@ -206,6 +305,67 @@ protected:
     QHash<int, QByteArray> roleNames() const;
 };
 
+/**
+ * @brief Proxy model that shows ranked search results of an issue model
+ *
+ * If no matches have been set, all issues are shown in source order. Otherwise, only the matching issues
+ * are shown, ordered by their rank.
+ */
+class IssueFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+private:
+    /// Rank of each matching issue by issue ID
+    QHash<int, int> ranks_;
+
+    /// Only show matching issues
+    bool active_ = false;
+
+public:
+    /**
+     * @brief Default constructor
+     *
+     * @param parent Parent QObject
+     */
+    IssueFilterModel( QObject* parent = nullptr );
+
+    /**
+     * @brief Show all issues
+     */
+    void clearMatches();
+
+    /**
+     * @brief Only show the specified issues
+     *
+     * @param issueIds IDs of the matching issues, best match first
+     */
+    void setMatches( const QVector<int>& issueIds );
+
+protected:
+    /**
+     * @brief Check whether a source row is a match
+     *
+     * @param sourceRow Source row
+     * @param sourceParent Source parent model index
+     *
+     * @return true if the row is shown, false otherwise
+     */
+    bool filterAcceptsRow( int sourceRow, const QModelIndex& sourceParent ) const;
+
+    /**
+     * @brief Compare the rank of two source rows
+     *
+     * If no matches have been set, the source order is kept.
+     *
+     * @param left Left source model index
+     * @param right Right source model index
+     *
+     * @return true if left ranks before right, false otherwise
+     */
+    bool lessThan( const QModelIndex& left, const QModelIndex& right ) const;
+};
+
 /**
  * @brief Class that represents the model of a simple item
  */
@@ -280,6 +440,15 @@ public:
      */
     void clear();
 
+    /**
+     * @brief Append simple items to the end of the model
+     *
+     * Emits a single row insertion for all items.
+     *
+     * @param items Simple items to append
+     */
+    void append( const QList<SimpleItem>& items );
+
     /**
      * @brief Append a simple item to the end of the model
      *
@@ -298,6 +467,15 @@ public:
      */
     bool removeRows( int begin, int count, const QModelIndex& parent = QModelIndex() );
 
+    /**
+     * @brief Replace the contents of the model
+     *
+     * Emits a single model reset.
+     *
+     * @param items New simple items
+     */
+    void reset( const QList<SimpleItem>& items );
+
     /**
      * @brief Change model data
      *
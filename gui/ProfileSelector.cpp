@@ -1,10 +1,7 @@
 #include "qtredmine/Logging.h"
 
 #include "ProfileSelector.h"
-
-#include <QRegularExpression>
-#include <QRegularExpressionMatch>
-#include <QSettings>
+#include "redtimer/ProfileStore.h"
 
 using namespace qtredmine;
 using namespace std;
@@ -62,8 +59,10 @@ ProfileSelector::display()
     ENTER();
 
     int id = 0;
+    QList<SimpleItem> items;
     for( const auto& profileId : profileIds_ )
-        profileModel_.push_back( SimpleItem(id++, profileId) );
+        items.push_back( SimpleItem(id++, profileId) );
+    profileModel_.reset( items );
 
     DEBUG()(profileModel_);
 
@@ -83,19 +82,9 @@ ProfileSelector::profileIds()
 {
     ENTER();
 
-    QSettings settings( QSettings::IniFormat, QSettings::UserScope, "Thomssen IT", "RedTimer" );
-
     QStringList profileIds;
-    for( const auto& group : settings.childGroups() )
-    {
-        QRegularExpressionMatch match = QRegularExpression("profile-(\\d+)").match( group );
-
-        // Not a profile group entry
-        if( !match.hasMatch() )
-            continue;
-
-        profileIds.push_back( settings.value(group+"/name").toString() );
-    }
+    for( const auto& profile : ProfileStore::profiles() )
+        profileIds.push_back( profile.name );
 
     RETURN( profileIds );
 }
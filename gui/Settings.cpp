@@ -5,8 +5,6 @@
 #include <QAbstractButton>
 #include <QInputDialog>
 #include <QQuickItem>
-#include <QRegularExpression>
-#include <QRegularExpressionMatch>
 
 using namespace qtredmine;
 using namespace std;
@@ -27,31 +25,21 @@ ProfileData::isValid( QString* errmsg ) const
 }
 
 Settings::Settings( MainWindow* mainWindow, const QString& profile )
-    : Window( "Settings", mainWindow ),
-      settings_( QSettings::IniFormat, QSettings::UserScope, "Thomssen IT", "RedTimer", this )
+    : Window( "Settings", mainWindow )
 {
     ENTER();
 
     // Find profile ID by name
     int maxProfileId = 0;
-    for( const auto& group : settings_.childGroups() )
+    for( const auto& entry : ProfileStore::profiles() )
     {
-        QRegularExpressionMatch match = QRegularExpression("profile-(\\d+)").match( group );
+        if( entry.id > maxProfileId )
+            maxProfileId = entry.id;
 
-        bool ok;
-        int profileId = match.captured(1).toInt( &ok );
-
-        // Not a profile group entry
-        if( !ok )
-            continue;
-
-        if( profileId > maxProfileId )
-            maxProfileId = profileId;
-
-        if( settings_.value(group+"/name").toString().toLower() == profile.toLower() )
+        if( entry.name.toLower() == profile.toLower() )
         {
-            data_.profileData.id = profileId;
-            data_.profileData.name = settings_.value(group+"/name").toString();
+            data_.profileData.id = entry.id;
+            data_.profileData.name = entry.name;
             break;
         }
     }
@@ -63,8 +51,7 @@ Settings::Settings( MainWindow* mainWindow, const QString& profile )
         data_.profileData.name = profile;
     }
 
-    // Connect to Redmine
-    redmine_ = new SimpleRedmineClient( this );
+    writer_ = new SettingsWriter( data_.profileData.id, this );
 
     // Settings window initialisation
     setModality( Qt::ApplicationModal );
@@ -100,48 +87,67 @@ Settings::apply()
 {
     ENTER();
 
-    bool reload = false;
-    applyProfileData( &reload );
+    bool reload = qml("apikey")->property("text").toString() != profileData()->apiKey
+                  || qml("url")->property("text").toString() != profileData()->url;
 
-    QString errmsg;
-    if( !profileData()->isValid( &errmsg ) )
-        message( errmsg, QtWarningMsg );
-
-    if( reload )
+    // Store the profile data and let the main window switch to it
+    auto finish = [=]()
     {
-        auto cb = [=](bool success, int id, RedmineError errorCode, QStringList errors)
-        {
-            CBENTER()(success)(id)(errorCode)(errors);
+        ENTER();
 
-            if( !success )
-            {
-                QString errorMsg = tr( "Could not save the time entry." );
-                for( const auto& error : errors )
-                    errorMsg.append("\n").append(error);
-                message( errorMsg, QtCriticalMsg );
+        applyProfileData();
 
-                CBRETURN();
-            }
+        QString errmsg;
+        if( !profileData()->isValid( &errmsg ) )
+            message( errmsg, QtWarningMsg );
 
-            save();
+        save();
 
-            DEBUG() << "Emitting applied() signal";
-            emit applied();
+        DEBUG() << "Emitting applied() signal";
+        emit applied();
 
-            CBRETURN();
-        };
+        refresh();
 
-        // Save current time before applying
-        ++callbackCounter_;
-        mainWindow()->stop( true, true, cb );
-    }
-    else
+        RETURN();
+    };
+
+    if( !reload )
     {
-        save();
-        emit applied();
+        finish();
+        RETURN();
     }
 
-    refresh();
+    auto cb = [=](bool success, int id, RedmineError errorCode, QStringList errors)
+    {
+        CBENTER()(success)(id)(errorCode)(errors);
+
+        if( !success )
+        {
+            QString errorMsg = tr( "Could not save the time entry." );
+            for( const auto& error : errors )
+                errorMsg.append("\n").append(error);
+            message( errorMsg, QtCriticalMsg );
+
+            CBRETURN();
+        }
+
+        // Only switch the login once the saved time has been sent using the current login
+        ++callbackCounter_;
+        mainWindow()->drainJournal( [=]()
+        {
+            CBENTER();
+
+            finish();
+
+            CBRETURN();
+        } );
+
+        CBRETURN();
+    };
+
+    // Save current time using the current profile data before applying
+    ++callbackCounter_;
+    mainWindow()->stop( true, cb );
 
     RETURN();
 }
@@ -236,15 +242,6 @@ Settings::applyProfileData( bool* reload )
             data->recentIssues.removeLast();
     }
 
-    redmine_->setCheckSsl( !data->ignoreSslErrors );
-    redmine_->setUrl( data->url );
-    redmine_->setAuthenticator( data->apiKey );
-
-    updateIssueCustomFields();
-    updateIssueStatuses();
-    updateTrackers();
-    updateTimeEntryCustomFields();
-
     RETURN();
 }
 
@@ -305,12 +302,10 @@ Settings::load( const bool apply )
     {
         ENTER();
 
-        QString prefix = QString("profile-%1/%2/%3").arg(data_.profileData.id).arg(name);
+        Window::Data& windowData = data_.windows.*field;
 
-        if( !settings_.value(prefix.arg("geometry")).isNull() )
-            (data_.windows.*field).geometry = settings_.value(prefix.arg("geometry")).toRect();
-        if( !settings_.value(prefix.arg("position")).isNull() )
-            (data_.windows.*field).position = settings_.value(prefix.arg("position")).toPoint();
+        windowData.geometry = writer_->value( name + "/geometry", windowData.geometry ).toRect();
+        windowData.position = writer_->value( name + "/position", windowData.position ).toPoint();
 
         DEBUG()((data_.windows.*field).position)((data_.windows.*field).geometry);
 
@@ -337,99 +332,59 @@ Settings::loadProfileData()
 
     ProfileData* data = &data_.profileData;
 
-    settings_.beginGroup( QString("profile-%1").arg(data_.profileData.id) );
+    auto value = [&]( const QString& key, const QVariant& defaultValue = QVariant() )
+    {
+        return writer_->value( key, defaultValue );
+    };
 
     // Connection
-    data->apiKey = settings_.value("apikey").toString();
-    data->ignoreSslErrors = settings_.value("ignoreSslErrors").toBool();
-    data->url = settings_.value("url").toString();
-
-    data->numRecentIssues = settings_.value("numRecentIssues").isValid()
-                           ? settings_.value("numRecentIssues").toInt()
-                           : 10;
-
-    data->startLocalServer = settings_.value("startLocalServer").isValid()
-                           ? settings_.value("startLocalServer").toBool()
-                           : true;
-
-    data->useCustomFields = settings_.value("useCustomFields").isValid()
-                           ? settings_.value("useCustomFields").toBool()
-                           : true;
-
-    data->activityId  = settings_.value("activity").isValid()
-                       ? settings_.value("activity").toInt()
-                       : NULL_ID;
-    data->issueId = settings_.value("issue").isValid()
-                   ? settings_.value("issue").toInt()
-                   : NULL_ID;
-    data->projectId = settings_.value("project").isValid()
-                     ? settings_.value("project").toInt()
-                     : NULL_ID;
-    data->workedOnId = settings_.value("workedOnId").isValid()
-                      ? settings_.value("workedOnId").toInt()
-                      : NULL_ID;
-    data->defaultTrackerId = settings_.value("defaultTrackerId").isValid()
-                            ? settings_.value("defaultTrackerId").toInt()
-                            : NULL_ID;
-
-    data->externalIdFieldId = settings_.value("externalIdFieldId").isValid()
-                            ? settings_.value("externalIdFieldId").toInt()
-                            : NULL_ID;
-
-    data->startTimeFieldId = settings_.value("startTimeFieldId").isValid()
-                            ? settings_.value("startTimeFieldId").toInt()
-                            : NULL_ID;
-    data->endTimeFieldId = settings_.value("endTimeFieldId").isValid()
-                          ? settings_.value("endTimeFieldId").toInt()
-                          : NULL_ID;
+    data->apiKey = value( "apikey" ).toString();
+    data->ignoreSslErrors = value( "ignoreSslErrors" ).toBool();
+    data->url = value( "url" ).toString();
+
+    data->numRecentIssues = value( "numRecentIssues", 10 ).toInt();
+    data->startLocalServer = value( "startLocalServer", true ).toBool();
+    data->useCustomFields = value( "useCustomFields", true ).toBool();
+
+    data->activityId = value( "activity", NULL_ID ).toInt();
+    data->issueId = value( "issue", NULL_ID ).toInt();
+    data->projectId = value( "project", NULL_ID ).toInt();
+    data->workedOnId = value( "workedOnId", NULL_ID ).toInt();
+    data->defaultTrackerId = value( "defaultTrackerId", NULL_ID ).toInt();
+    data->externalIdFieldId = value( "externalIdFieldId", NULL_ID ).toInt();
+    data->startTimeFieldId = value( "startTimeFieldId", NULL_ID ).toInt();
+    data->endTimeFieldId = value( "endTimeFieldId", NULL_ID ).toInt();
 
     // Shortcuts
-    data->shortcutCreateIssue = settings_.value("shortcutCreateIssue").isValid()
-                               ? settings_.value("shortcutCreateIssue").toString()
-                               : "Ctrl+Alt+C";
-    data->shortcutSelectIssue = settings_.value("shortcutSelectIssue").isValid()
-                               ? settings_.value("shortcutSelectIssue").toString()
-                               : "Ctrl+Alt+L";
-    data->shortcutStartStop = settings_.value("shortcutStartStop").isValid()
-                             ? settings_.value("shortcutStartStop").toString()
-                             : "Ctrl+Alt+S";
-    data->shortcutToggle = settings_.value("shortcutToggle").isValid()
-                          ? settings_.value("shortcutToggle").toString()
-                          : "Ctrl+Alt+R";
+    data->shortcutCreateIssue = value( "shortcutCreateIssue", "Ctrl+Alt+C" ).toString();
+    data->shortcutSelectIssue = value( "shortcutSelectIssue", "Ctrl+Alt+L" ).toString();
+    data->shortcutStartStop = value( "shortcutStartStop", "Ctrl+Alt+S" ).toString();
+    data->shortcutToggle = value( "shortcutToggle", "Ctrl+Alt+R" ).toString();
 
     // Interface
 #ifdef Q_OS_MAC
     data->useSystemTrayIcon = true;
     data->closeToTray = true;
 #else
-    data->useSystemTrayIcon = settings_.value("useSystemTrayIcon").isValid()
-                             ? settings_.value("useSystemTrayIcon").toBool()
-                             : true;
-    data->closeToTray = settings_.value("closeToTray").isValid()
-                             ? settings_.value("closeToTray").toBool()
-                             : true;
+    data->useSystemTrayIcon = value( "useSystemTrayIcon", true ).toBool();
+    data->closeToTray = value( "closeToTray", true ).toBool();
 #endif
 
     // Recently used issues
     data->recentIssues.clear();
-    int size = settings_.beginReadArray( "recentIssues" );
+    int size = value( "recentIssues/size", 0 ).toInt();
     for( int i = 0; i < size; ++i )
     {
-        settings_.setArrayIndex( i );
+        QString arrayPrefix = QString("recentIssues/%1/").arg(i + 1);
 
-        Issue issue;
-        issue.id      = settings_.value("id").toInt();
-        issue.subject = settings_.value("subject").toString();
+        Item issue;
+        issue.id   = value( arrayPrefix + "id" ).toInt();
+        issue.name = value( arrayPrefix + "subject" ).toString();
         data->recentIssues.append( issue );
     }
-    settings_.endArray();
 
     // Internal data
-    data->hidden = settings_.value("hidden").isValid()
-                   ? settings_.value("hidden").toBool()
-                   : false;
-
-    settings_.endGroup();
+    data->hidden = value( "hidden", false ).toBool();
 
     DEBUG()(data);
 
@@ -485,10 +440,8 @@ Settings::save()
     {
         ENTER();
 
-        QString prefix = QString("profile-%1/%2/%3").arg(data_.profileData.id).arg(name);
-
-        settings_.setValue( prefix.arg("geometry"), (data_.windows.*field).geometry );
-        settings_.setValue( prefix.arg("position"), (data_.windows.*field).position );
+        writer_->setValue( name + "/geometry", (data_.windows.*field).geometry );
+        writer_->setValue( name + "/position", (data_.windows.*field).position );
 
         RETURN();
     };
@@ -500,7 +453,9 @@ Settings::save()
 
     saveProfileData();
 
-    settings_.sync();
+    // List new profiles in the profile index
+    if( !indexed_ )
+        indexed_ = ProfileStore::addProfile( data_.profileData.id, data_.profileData.name );
 
     RETURN();
 }
@@ -512,50 +467,61 @@ Settings::saveProfileData()
 
     ProfileData* data = &data_.profileData;
 
-    settings_.beginGroup( QString("profile-%1").arg(data_.profileData.id) );
+    auto setValue = [&]( const QString& key, const QVariant& value )
+    {
+        writer_->setValue( key, value );
+    };
 
     // Connection
-    settings_.setValue( "apikey",            data->apiKey );
-    settings_.setValue( "ignoreSslErrors",   data->ignoreSslErrors );
-    settings_.setValue( "numRecentIssues",   data->numRecentIssues );
-    settings_.setValue( "startLocalServer",  data->startLocalServer );
-    settings_.setValue( "url",               data->url );
-    settings_.setValue( "useCustomFields",   data->useCustomFields );
-    settings_.setValue( "workedOnId",        data->workedOnId );
-    settings_.setValue( "defaultTrackerId",  data->defaultTrackerId );
-    settings_.setValue( "externalIdFieldId", data->externalIdFieldId );
-    settings_.setValue( "startTimeFieldId",  data->startTimeFieldId );
-    settings_.setValue( "endTimeFieldId",    data->endTimeFieldId );
-
-    settings_.setValue( "activity", data->activityId );
-    settings_.setValue( "issue",    data->issueId );
-    settings_.setValue( "project",  data->projectId );
+    setValue( "apikey",            data->apiKey );
+    setValue( "ignoreSslErrors",   data->ignoreSslErrors );
+    setValue( "numRecentIssues",   data->numRecentIssues );
+    setValue( "startLocalServer",  data->startLocalServer );
+    setValue( "url",               data->url );
+    setValue( "useCustomFields",   data->useCustomFields );
+    setValue( "workedOnId",        data->workedOnId );
+    setValue( "defaultTrackerId",  data->defaultTrackerId );
+    setValue( "externalIdFieldId", data->externalIdFieldId );
+    setValue( "startTimeFieldId",  data->startTimeFieldId );
+    setValue( "endTimeFieldId",    data->endTimeFieldId );
+
+    setValue( "activity", data->activityId );
+    setValue( "issue",    data->issueId );
+    setValue( "project",  data->projectId );
 
     // Shortcuts
-    settings_.setValue("shortcutCreateIssue", data->shortcutCreateIssue );
-    settings_.setValue("shortcutSelectIssue", data->shortcutSelectIssue );
-    settings_.setValue("shortcutStartStop",   data->shortcutStartStop );
-    settings_.setValue("shortcutToggle",      data->shortcutToggle );
+    setValue( "shortcutCreateIssue", data->shortcutCreateIssue );
+    setValue( "shortcutSelectIssue", data->shortcutSelectIssue );
+    setValue( "shortcutStartStop",   data->shortcutStartStop );
+    setValue( "shortcutToggle",      data->shortcutToggle );
 
     // Interface
-    settings_.setValue( "useSystemTrayIcon", data->useSystemTrayIcon );
-    settings_.setValue( "closeToTray",       data->closeToTray );
+    setValue( "useSystemTrayIcon", data->useSystemTrayIcon );
+    setValue( "closeToTray",       data->closeToTray );
 
-    // Recently used issues for the data
-    settings_.beginWriteArray( "recentIssues" );
+    // Recently used issues for the data, using the key layout of imported QSettings arrays
+    setValue( "recentIssues/size", data->recentIssues.size() );
     for( int i = 0; i < data->recentIssues.size(); ++i )
     {
-        settings_.setArrayIndex( i );
-        settings_.setValue( "id",      data->recentIssues.at(i).id );
-        settings_.setValue( "subject", data->recentIssues.at(i).subject );
+        QString arrayPrefix = QString("recentIssues/%1/").arg(i + 1);
+        setValue( arrayPrefix + "id",      data->recentIssues.at(i).id );
+        setValue( arrayPrefix + "subject", data->recentIssues.at(i).name );
     }
-    settings_.endArray();
 
     // Internal
-    settings_.setValue( "hidden", mainWindow()->hidden() );
-    settings_.setValue( "name",   data->name );
+    setValue( "hidden", mainWindow()->hidden() );
+    setValue( "name",   data->name );
 
-    settings_.endGroup();
+    RETURN();
+}
+
+void
+Settings::sync()
+{
+    ENTER();
+
+    if( !writer_->sync() )
+        DEBUG() << "Could not write the settings";
 
     RETURN();
 }
@@ -588,13 +554,9 @@ Settings::updateIssueStatuses()
         RETURN();
     }
 
-    redmine_->setCheckSsl( !profileData()->ignoreSslErrors );
-    redmine_->setUrl( profileData()->url );
-    redmine_->setAuthenticator( profileData()->apiKey );
-
     ++callbackCounter_;
-    redmine_->retrieveIssueStatuses( [&]( IssueStatuses issueStatuses, RedmineError redmineError,
-                                          QStringList errors )
+    metadataCache()->retrieveIssueStatuses( [&]( IssueStatuses issueStatuses, RedmineError redmineError,
+                                                 QStringList errors )
     {
         CBENTER();
 
@@ -614,16 +576,18 @@ Settings::updateIssueStatuses()
         qSort( issueStatuses.begin(), issueStatuses.end(),
                []( const IssueStatus& a, const IssueStatus& b ){ return a.id < b.id; } );
 
-        issueStatusModel_.clear();
-        issueStatusModel_.push_back( SimpleItem(NULL_ID, "Choose issue status") );
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose issue status") );
         for( const auto& issueStatus : issueStatuses )
         {
             if( issueStatus.id == profileData()->workedOnId )
-                currentIndex = issueStatusModel_.rowCount();
+                currentIndex = items.size();
 
-            issueStatusModel_.push_back( SimpleItem(issueStatus) );
+            items.push_back( SimpleItem(issueStatus) );
         }
 
+        issueStatusModel_.reset( items );
+
         DEBUG()(issueStatusModel_)(profileData()->workedOnId)(currentIndex);
 
         qml("workedOn")->setProperty( "enabled", true );
@@ -665,14 +629,9 @@ Settings::updateIssueCustomFields()
     filter.format = "string";
     filter.type   = "issue";
 
-    // @todo Remove from here
-    redmine_->setCheckSsl( !profileData()->ignoreSslErrors );
-    redmine_->setUrl( profileData()->url );
-    redmine_->setAuthenticator( profileData()->apiKey );
-
     ++callbackCounter_;
-    redmine_->retrieveCustomFields( [&]( CustomFields customFields, RedmineError redmineError,
-                                         QStringList errors )
+    metadataCache()->retrieveCustomFields( [&]( CustomFields customFields, RedmineError redmineError,
+                                                QStringList errors )
     {
         CBENTER();
 
@@ -694,8 +653,8 @@ Settings::updateIssueCustomFields()
             firstEntry = "No issue fields found";
 
         int externalIdCurrentIndex = 0;
-        externalIdModel_.clear();
-        externalIdModel_.push_back( SimpleItem(NULL_ID, firstEntry) );
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, firstEntry) );
 
         sort( customFields.begin(), customFields.end(),
               [](CustomField l, CustomField r){ return l.name < r.name;} );
@@ -704,10 +663,12 @@ Settings::updateIssueCustomFields()
         for( const auto& customField : customFields )
         {
             if( customField.id == profileData()->externalIdFieldId )
-                externalIdCurrentIndex = externalIdModel_.rowCount();
-            externalIdModel_.push_back( SimpleItem(customField) );
+                externalIdCurrentIndex = items.size();
+            items.push_back( SimpleItem(customField) );
         }
 
+        externalIdModel_.reset( items );
+
         qml("externalId")->setProperty( "currentIndex", -1 );
         qml("externalId")->setProperty( "currentIndex", externalIdCurrentIndex );
         qml("externalId")->setProperty( "enabled", true );
@@ -754,14 +715,9 @@ Settings::updateTimeEntryCustomFields()
     filter.format = "string";
     filter.type   = "time_entry";
 
-    // @todo Remove from here
-    redmine_->setCheckSsl( !profileData()->ignoreSslErrors );
-    redmine_->setUrl( profileData()->url );
-    redmine_->setAuthenticator( profileData()->apiKey );
-
     ++callbackCounter_;
-    redmine_->retrieveCustomFields( [&]( CustomFields customFields, RedmineError redmineError,
-                                         QStringList errors )
+    metadataCache()->retrieveCustomFields( [&]( CustomFields customFields, RedmineError redmineError,
+                                                QStringList errors )
     {
         CBENTER();
 
@@ -782,14 +738,14 @@ Settings::updateTimeEntryCustomFields()
         else
             firstEntry = "No time entry fields found";
 
-        startTimeModel_.clear();
-        endTimeModel_.clear();
-
         int startTimeCurrentIndex = 0;
         int endTimeCurrentIndex = 0;
 
-        startTimeModel_.push_back( SimpleItem(NULL_ID, firstEntry) );
-        endTimeModel_.push_back( SimpleItem(NULL_ID, firstEntry) );
+        QList<SimpleItem> startTimeItems;
+        QList<SimpleItem> endTimeItems;
+
+        startTimeItems.push_back( SimpleItem(NULL_ID, firstEntry) );
+        endTimeItems.push_back( SimpleItem(NULL_ID, firstEntry) );
 
         sort( customFields.begin(), customFields.end(),
               [](CustomField l, CustomField r){ return l.name < r.name;} );
@@ -798,14 +754,17 @@ Settings::updateTimeEntryCustomFields()
         for( const auto& customField : customFields )
         {
             if( customField.id == profileData()->startTimeFieldId )
-                startTimeCurrentIndex = startTimeModel_.rowCount();
-            startTimeModel_.push_back( SimpleItem(customField) );
+                startTimeCurrentIndex = startTimeItems.size();
+            startTimeItems.push_back( SimpleItem(customField) );
 
             if( customField.id == profileData()->endTimeFieldId )
-                endTimeCurrentIndex = endTimeModel_.rowCount();
-            endTimeModel_.push_back( SimpleItem(customField) );
+                endTimeCurrentIndex = endTimeItems.size();
+            endTimeItems.push_back( SimpleItem(customField) );
         }
 
+        startTimeModel_.reset( startTimeItems );
+        endTimeModel_.reset( endTimeItems );
+
         qml("startTime")->setProperty( "currentIndex", -1 );
         qml("startTime")->setProperty( "currentIndex", startTimeCurrentIndex );
         qml("startTime")->setProperty( "enabled", true );
@@ -837,12 +796,8 @@ Settings::updateTrackers()
         RETURN();
     }
 
-    redmine_->setCheckSsl( !profileData()->ignoreSslErrors );
-    redmine_->setUrl( profileData()->url );
-    redmine_->setAuthenticator( profileData()->apiKey );
-
     ++callbackCounter_;
-    redmine_->retrieveTrackers( [&]( Trackers trackers, RedmineError redmineError, QStringList errors )
+    metadataCache()->retrieveTrackers( [&]( Trackers trackers, RedmineError redmineError, QStringList errors )
     {
         CBENTER();
 
@@ -862,16 +817,18 @@ Settings::updateTrackers()
         qSort( trackers.begin(), trackers.end(),
                []( const Tracker& a, const Tracker& b ){ return a.id < b.id; } );
 
-        trackerModel_.clear();
-        trackerModel_.push_back( SimpleItem(NULL_ID, "Choose tracker") );
+        QList<SimpleItem> items;
+        items.push_back( SimpleItem(NULL_ID, "Choose tracker") );
         for( const auto& tracker : trackers )
         {
             if( tracker.id == profileData()->defaultTrackerId )
-                currentIndex = trackerModel_.rowCount();
+                currentIndex = items.size();
 
-            trackerModel_.push_back( SimpleItem(tracker) );
+            items.push_back( SimpleItem(tracker) );
         }
 
+        trackerModel_.reset( items );
+
         DEBUG()(trackerModel_)(profileData()->defaultTrackerId)(currentIndex);
 
         qml("defaultTracker")->setProperty( "enabled", true );
@@ -6,13 +6,14 @@
 #include "Window.h"
 
 #include "qtredmine/SimpleRedmineClient.h"
+#include "redtimer/ProfileStore.h"
+#include "redtimer/SettingsWriter.h"
 
 #include <QObject>
 #include <QQmlContext>
 #include <QQuickItem>
 #include <QQuickView>
 #include <QSet>
-#include <QSettings>
 #include <QSortFilterProxyModel>
 
 namespace redtimer {
@@ -95,8 +96,8 @@ struct ProfileData
     /// Last opened project
     int projectId;
 
-    /// Recently opened issues
-    qtredmine::Issues recentIssues;
+    /// Recently opened issues by ID and subject
+    QList<qtredmine::Item> recentIssues;
 
     /// Window was hidden on exit
     bool hidden;
@@ -148,14 +149,14 @@ class Settings : public Window
     Q_OBJECT
 
 private:
-    /// Redmine connection object
-    qtredmine::SimpleRedmineClient* redmine_;
-
     /// Initialised
     bool initialised_ = false;
 
-    /// Application settings
-    QSettings settings_;
+    /// Write-behind writer for the profile settings
+    SettingsWriter* writer_ = nullptr;
+
+    /// Profile is listed in the profile index
+    bool indexed_ = false;
 
     /// Cached issue statuses
     SimpleModel issueStatusModel_;
@@ -219,9 +220,16 @@ public:
 
     /**
      * @brief Save settings to settings file
+     *
+     * The profile is only written if settings have changed, in the background after a short delay.
      */
     void save();
 
+    /**
+     * @brief Write all saved settings to the settings file and wait until they have been written
+     */
+    void sync();
+
     /**
      * @brief Get the window data
      *
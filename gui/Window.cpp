@@ -24,6 +24,9 @@ Window::Window( QString qml, MainWindow* mainWindow, std::function<void()> close
     if( !settings_ && mainWindow_ )
         settings_ = mainWindow_->settings();
 
+    if( !redmine_ && mainWindow_ )
+        redmine_ = mainWindow_->redmine();
+
     setResizeMode( QQuickView::SizeRootObjectToView );
 
     setMinimumHeight( height() );
@@ -102,6 +105,19 @@ Window::deleteMessage( QString text )
     RETURN();
 }
 
+IssueRegistry*
+Window::issueRegistry()
+{
+    ENTER();
+
+    IssueRegistry* issueRegistry = nullptr;
+
+    if( mainWindow_ )
+        issueRegistry = mainWindow_->issueRegistry();
+
+    RETURN( issueRegistry );
+}
+
 MainWindow*
 Window::mainWindow()
 {
@@ -109,6 +125,19 @@ Window::mainWindow()
     RETURN( mainWindow_ );
 }
 
+MetadataCache*
+Window::metadataCache()
+{
+    ENTER();
+
+    MetadataCache* metadataCache = nullptr;
+
+    if( mainWindow_ )
+        metadataCache = mainWindow_->metadataCache();
+
+    RETURN( metadataCache );
+}
+
 QQuickItem*
 Window::message( QString text, QtMsgType type, bool force )
 {
@@ -220,6 +249,13 @@ Window::qml( QString qmlItem )
     }
 }
 
+RedmineSession*
+Window::redmine()
+{
+    ENTER();
+    RETURN( redmine_ );
+}
+
 void
 Window::setCtxProperty( QString key, QObject* value )
 {
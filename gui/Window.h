@@ -13,7 +13,10 @@
 namespace redtimer {
 
 // forward declaration
+class IssueRegistry;
 class MainWindow;
+class MetadataCache;
+class RedmineSession;
 class Settings;
 struct ProfileData;
 
@@ -43,6 +46,9 @@ private:
     Settings* settings_ = nullptr;
 
 protected:
+    /// Redmine session shared by all windows
+    RedmineSession* redmine_ = nullptr;
+
     /// Counter to ensure that there are no idle callbacks after deleting the object
     int callbackCounter_ = 0;
 
@@ -63,6 +69,13 @@ protected:
      */
     bool connected();
 
+    /**
+     * @brief Get the issue registry shared by all windows
+     *
+     * @return Issue registry
+     */
+    IssueRegistry* issueRegistry();
+
     /**
      * @brief Get the main window
      *
@@ -70,6 +83,13 @@ protected:
      */
     MainWindow* mainWindow();
 
+    /**
+     * @brief Get the metadata cache shared by all windows
+     *
+     * @return Metadata cache
+     */
+    MetadataCache* metadataCache();
+
     /**
      * @brief Get the current profile data
      *
@@ -88,6 +108,13 @@ protected:
      */
     QQuickItem* qml( QString qmlItem = "" );
 
+    /**
+     * @brief Get the Redmine session shared by all windows
+     *
+     * @return Redmine session
+     */
+    RedmineSession* redmine();
+
     /**
      * @brief Get the settings object
      *
@@ -8,6 +8,7 @@ ColumnLayout {
     property alias issues: issues
     property alias project: project
     property alias search: search
+    property alias progress: progress
     property alias assignee: assignee
 
     ComboBox {
@@ -34,14 +35,57 @@ ColumnLayout {
         textRole: "name"
     }
 
+    ComboBox {
+        id: query
+        Layout.fillWidth: true
+        objectName: "query"
+        model: queryModel
+        textRole: "name"
+    }
+
+    RowLayout {
+        Layout.fillWidth: true
+
+        ComboBox {
+            id: status
+            Layout.fillWidth: true
+            objectName: "status"
+            model: statusModel
+            textRole: "name"
+        }
+
+        ComboBox {
+            id: tracker
+            Layout.fillWidth: true
+            objectName: "tracker"
+            model: trackerModel
+            textRole: "name"
+        }
+
+        ComboBox {
+            id: updated
+            Layout.fillWidth: true
+            objectName: "updated"
+            model: updatedModel
+            textRole: "name"
+        }
+    }
+
     TextField {
         id: search
         objectName: "search"
         Layout.fillWidth: true
-        placeholderText: qsTr("Search in issue list")
+        placeholderText: qsTr("Search by ID, subject, description or custom field, press Enter to search on the server")
         focus: true
     }
 
+    Label {
+        id: progress
+        objectName: "progress"
+        Layout.fillWidth: true
+        color: "gray"
+    }
+
     ListView {
         id: issues
         boundsBehavior: Flickable.StopAtBounds
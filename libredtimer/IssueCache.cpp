@@ -0,0 +1,210 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/IssueCache.h"
+#include "redtimer/Serialisation.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+/// Magic number of the cache file
+#define ISSUE_CACHE_MAGIC 0x52544943 // "RTIC"
+
+IssueCache::IssueCache( int maxIssues )
+    : maxIssues_( maxIssues )
+{}
+
+void
+IssueCache::clear()
+{
+    ENTER();
+
+    issues_.clear();
+    order_.clear();
+
+    if( !fileName_.isEmpty() )
+        QFile::remove( fileName_ );
+
+    RETURN();
+}
+
+bool
+IssueCache::contains( int issueId ) const
+{
+    ENTER()(issueId);
+    RETURN( issues_.contains(issueId) );
+}
+
+bool
+IssueCache::insert( const Issue& issue )
+{
+    ENTER()(issue.id)(issue.updatedOn);
+
+    if( issue.id == NULL_ID )
+        RETURN( false );
+
+    auto it = issues_.find( issue.id );
+    bool changed = it == issues_.end() || it->updatedOn != issue.updatedOn || !issue.updatedOn.isValid();
+
+    touch( issue.id );
+
+    if( !changed )
+        RETURN( false );
+
+    issues_.insert( issue.id, issue );
+
+    // Crop the cache after maxIssues_ entries
+    while( order_.size() > maxIssues_ )
+        issues_.remove( order_.takeLast() );
+
+    save();
+
+    RETURN( true );
+}
+
+void
+IssueCache::insertUnconfirmed( Issue issue )
+{
+    ENTER()(issue.id);
+
+    issue.updatedOn = QDateTime();
+    insert( issue );
+
+    RETURN();
+}
+
+Issue
+IssueCache::issue( int issueId )
+{
+    ENTER()(issueId);
+
+    if( !issues_.contains(issueId) )
+        RETURN( Issue() );
+
+    touch( issueId );
+
+    RETURN( issues_.value(issueId) );
+}
+
+bool
+IssueCache::load()
+{
+    ENTER()(fileName_);
+
+    issues_.clear();
+    order_.clear();
+
+    QFile file( fileName_ );
+    if( !file.open(QIODevice::ReadOnly) )
+        RETURN( false );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    if( !readHeader(stream, ISSUE_CACHE_MAGIC, VERSION, url_) )
+    {
+        DEBUG() << "Discarding outdated issue cache";
+        RETURN( false );
+    }
+
+    qint32 count;
+    stream >> count;
+
+    for( qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i )
+    {
+        Issue issue;
+        stream >> issue;
+
+        if( stream.status() != QDataStream::Ok )
+            break;
+
+        issues_.insert( issue.id, issue );
+        order_.append( issue.id );
+    }
+
+    if( stream.status() != QDataStream::Ok )
+    {
+        DEBUG() << "Issue cache is corrupt";
+        issues_.clear();
+        order_.clear();
+        RETURN( false );
+    }
+
+    DEBUG()(issues_.size());
+
+    RETURN( true );
+}
+
+void
+IssueCache::open( int profileId, const QString& url )
+{
+    ENTER()(profileId)(url);
+
+    QDir dir( QStandardPaths::writableLocation(QStandardPaths::CacheLocation) );
+    QString fileName = dir.filePath( QString("profile-%1/issues.cache").arg(profileId) );
+
+    if( fileName == fileName_ && url == url_ )
+        RETURN();
+
+    fileName_ = fileName;
+    url_ = url;
+
+    load();
+
+    RETURN();
+}
+
+void
+IssueCache::remove( int issueId )
+{
+    ENTER()(issueId);
+
+    if( !issues_.remove(issueId) )
+        RETURN();
+
+    order_.removeOne( issueId );
+    save();
+
+    RETURN();
+}
+
+bool
+IssueCache::save()
+{
+    ENTER()(fileName_);
+
+    if( fileName_.isEmpty() )
+        RETURN( false );
+
+    QDir().mkpath( QFileInfo(fileName_).absolutePath() );
+
+    QSaveFile file( fileName_ );
+    if( !file.open(QIODevice::WriteOnly) )
+        RETURN( false );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    writeHeader( stream, ISSUE_CACHE_MAGIC, VERSION, url_ );
+    stream << (qint32)order_.size();
+    for( const auto& issueId : order_ )
+        stream << issues_[issueId];
+
+    RETURN( file.commit() );
+}
+
+void
+IssueCache::touch( int issueId )
+{
+    order_.removeOne( issueId );
+    order_.prepend( issueId );
+}
+
+} // redtimer
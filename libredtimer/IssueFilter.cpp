@@ -0,0 +1,122 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/IssueFilter.h"
+
+#include <QRegularExpression>
+#include <QUrl>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+const int IssueFilter::OPEN_STATUSES;
+const int IssueFilter::CLOSED_STATUSES;
+const int IssueFilter::ALL_STATUSES;
+
+namespace {
+
+/// Custom field term of a search text
+const QRegularExpression CUSTOM_FIELD_TERM( "^cf_(\\d+)[:=](.+)$" );
+
+/**
+ * @brief Percent-encode a parameter value
+ */
+QString
+encode( const QString& value )
+{
+    return QString::fromLatin1( QUrl::toPercentEncoding(value) );
+}
+
+} // anonymous
+
+bool
+IssueFilter::isEmpty() const
+{
+    ENTER();
+    RETURN( parameters().isEmpty() );
+}
+
+QString
+IssueFilter::localSearchText( const QString& text )
+{
+    ENTER()(text);
+
+    QStringList terms;
+    for( const auto& term : text.split(' ', QString::SkipEmptyParts) )
+        if( !CUSTOM_FIELD_TERM.match(term).hasMatch() )
+            terms.append( term );
+
+    RETURN( terms.join(' ') );
+}
+
+QString
+IssueFilter::parameters() const
+{
+    ENTER();
+
+    QStringList parameters;
+
+    if( queryId != NULL_ID )
+        parameters.append( QString("query_id=%1").arg(queryId) );
+
+    switch( statusId )
+    {
+    case NULL_ID:
+        break;
+    case OPEN_STATUSES:
+        parameters.append( "status_id=open" );
+        break;
+    case CLOSED_STATUSES:
+        parameters.append( "status_id=closed" );
+        break;
+    case ALL_STATUSES:
+        parameters.append( "status_id=*" );
+        break;
+    default:
+        parameters.append( QString("status_id=%1").arg(statusId) );
+    }
+
+    if( trackerId != NULL_ID )
+        parameters.append( QString("tracker_id=%1").arg(trackerId) );
+
+    QString from = updatedFrom.toString( Qt::ISODate );
+    QString to = updatedTo.toString( Qt::ISODate );
+
+    if( updatedFrom.isValid() && updatedTo.isValid() )
+        parameters.append( "updated_on=" + encode(QString("><%1|%2").arg(from).arg(to)) );
+    else if( updatedFrom.isValid() )
+        parameters.append( "updated_on=" + encode(">=" + from) );
+    else if( updatedTo.isValid() )
+        parameters.append( "updated_on=" + encode("<=" + to) );
+
+    if( !subject.trimmed().isEmpty() )
+        parameters.append( "subject=" + encode("~" + subject.trimmed()) );
+
+    for( auto it = customFields.constBegin(); it != customFields.constEnd(); ++it )
+        parameters.append( QString("cf_%1=%2").arg(it.key()).arg(encode(it.value())) );
+
+    RETURN( parameters.join('&') );
+}
+
+void
+IssueFilter::setSearchText( const QString& text )
+{
+    ENTER()(text);
+
+    QStringList terms;
+    customFields.clear();
+
+    for( const auto& term : text.split(' ', QString::SkipEmptyParts) )
+    {
+        QRegularExpressionMatch match = CUSTOM_FIELD_TERM.match( term );
+        if( match.hasMatch() )
+            customFields.insert( match.captured(1).toInt(), match.captured(2) );
+        else
+            terms.append( term );
+    }
+
+    subject = terms.join(' ');
+
+    RETURN();
+}
+
+} // redtimer
@@ -0,0 +1,237 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/IssueIndex.h"
+
+#include <algorithm>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+void
+IssueIndex::add( int issueId, const QString& subject, const CustomFields& customFields,
+                 const QString& description )
+{
+    if( tokens_.contains(issueId) )
+        remove( issueId );
+
+    // Collect the highest weight of each token
+    QHash<QString, int> weights;
+    auto addText = [&weights]( const QString& text, int weight )
+    {
+        for( const auto& token : tokenise(text) )
+        {
+            int& current = weights[token];
+            current = qMax( current, weight );
+        }
+    };
+
+    addText( QString::number(issueId), ID_WEIGHT );
+    addText( subject, SUBJECT_WEIGHT );
+    for( const auto& customField : customFields )
+        for( const auto& value : customField.values )
+            addText( value, CUSTOM_FIELD_WEIGHT );
+    addText( description, DESCRIPTION_WEIGHT );
+
+    for( auto it = weights.constBegin(); it != weights.constEnd(); ++it )
+        postings_[it.key()].insert( issueId, it.value() );
+
+    tokens_.insert( issueId, weights.keys() );
+}
+
+void
+IssueIndex::add( const Issue& issue )
+{
+    add( issue.id, issue.subject, issue.customFields, issue.description );
+}
+
+void
+IssueIndex::add( const Issues& issues )
+{
+    for( const auto& issue : issues )
+        add( issue );
+}
+
+void
+IssueIndex::add( const IssueStore::Block& block )
+{
+    for( int row = 0; row < block.size(); ++row )
+        add( block.ids[row], block.subjects[row], block.customFields(row), block.description(row) );
+}
+
+void
+IssueIndex::clear()
+{
+    ENTER();
+
+    postings_.clear();
+    tokens_.clear();
+
+    RETURN();
+}
+
+bool
+IssueIndex::contains( int issueId ) const
+{
+    ENTER()(issueId);
+    RETURN( tokens_.contains(issueId) );
+}
+
+void
+IssueIndex::merge( const IssueIndex& other )
+{
+    ENTER()(other.size());
+
+    for( auto it = other.tokens_.constBegin(); it != other.tokens_.constEnd(); ++it )
+    {
+        if( tokens_.contains(it.key()) )
+            remove( it.key() );
+
+        tokens_.insert( it.key(), it.value() );
+    }
+
+    for( auto it = other.postings_.constBegin(); it != other.postings_.constEnd(); ++it )
+    {
+        QHash<int, int>& posting = postings_[it.key()];
+        if( posting.isEmpty() )
+        {
+            posting = it.value();
+            continue;
+        }
+
+        for( auto weight = it->constBegin(); weight != it->constEnd(); ++weight )
+            posting.insert( weight.key(), weight.value() );
+    }
+
+    RETURN();
+}
+
+void
+IssueIndex::remove( int issueId )
+{
+    auto tokens = tokens_.find( issueId );
+    if( tokens == tokens_.end() )
+        return;
+
+    for( const auto& token : *tokens )
+    {
+        auto posting = postings_.find( token );
+        if( posting == postings_.end() )
+            continue;
+
+        posting->remove( issueId );
+        if( posting->isEmpty() )
+            postings_.erase( posting );
+    }
+
+    tokens_.erase( tokens );
+}
+
+QVector<int>
+IssueIndex::search( const QString& query, const QSet<int>* candidates ) const
+{
+    QStringList terms = tokenise( query );
+    if( terms.isEmpty() )
+        return QVector<int>();
+
+    // Match the longest terms first since they usually match the fewest issues
+    std::sort( terms.begin(), terms.end(),
+               []( const QString& l, const QString& r ){ return l.size() > r.size(); } );
+
+    QHash<int, int> scores;
+    bool first = true;
+
+    for( const auto& term : terms )
+    {
+        // Best score of each issue for this term
+        QHash<int, int> termScores;
+
+        for( auto it = postings_.lowerBound(term); it != postings_.constEnd() && it.key().startsWith(term); ++it )
+        {
+            int factor = it.key().size() == term.size() ? 2 : 1;
+
+            for( auto posting = it->constBegin(); posting != it->constEnd(); ++posting )
+            {
+                // Only issues that matched all previous terms are of interest
+                if( first ? (candidates && !candidates->contains(posting.key()))
+                          : !scores.contains(posting.key()) )
+                    continue;
+
+                int& score = termScores[posting.key()];
+                score = qMax( score, posting.value() * factor );
+            }
+        }
+
+        if( first )
+        {
+            scores = termScores;
+            first = false;
+        }
+        else
+        {
+            for( auto it = scores.begin(); it != scores.end(); )
+            {
+                auto termScore = termScores.constFind( it.key() );
+                if( termScore == termScores.constEnd() )
+                {
+                    it = scores.erase( it );
+                    continue;
+                }
+
+                it.value() += termScore.value();
+                ++it;
+            }
+        }
+
+        if( scores.isEmpty() )
+            break;
+    }
+
+    // Rank by score, newer issues first
+    QVector<QPair<int, int>> ranked;
+    ranked.reserve( scores.size() );
+    for( auto it = scores.constBegin(); it != scores.constEnd(); ++it )
+        ranked.push_back( qMakePair(it.value(), it.key()) );
+
+    std::sort( ranked.begin(), ranked.end(),
+               []( const QPair<int, int>& l, const QPair<int, int>& r ){ return l > r; } );
+
+    QVector<int> issueIds;
+    issueIds.reserve( ranked.size() );
+    for( const auto& entry : ranked )
+        issueIds.push_back( entry.second );
+
+    return issueIds;
+}
+
+int
+IssueIndex::size() const
+{
+    return tokens_.size();
+}
+
+QStringList
+IssueIndex::tokenise( const QString& text )
+{
+    QStringList tokens;
+    QString token;
+
+    for( const QChar& c : text )
+    {
+        if( c.isLetterOrNumber() )
+        {
+            token.append( c.toLower() );
+        }
+        else if( !token.isEmpty() )
+        {
+            tokens.append( token );
+            token.clear();
+        }
+    }
+
+    if( !token.isEmpty() )
+        tokens.append( token );
+
+    return tokens;
+}
+
+} // redtimer
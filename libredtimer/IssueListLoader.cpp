@@ -0,0 +1,269 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/IssueListLoader.h"
+
+#include <QFutureWatcher>
+#include <QPointer>
+#include <QtConcurrent>
+
+#include <memory>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+IssueListLoader::IssueListLoader( RedmineSession* redmine, QObject* parent )
+    : QObject( parent ),
+      redmine_( redmine )
+{}
+
+void
+IssueListLoader::cancel()
+{
+    ENTER()(loading_);
+
+    ++generation_;
+    loading_ = false;
+    inFlight_ = 0;
+    pages_.clear();
+
+    RETURN();
+}
+
+void
+IssueListLoader::dispatch()
+{
+    ENTER()(offset_)(total_)(end_)(inFlight_);
+
+    // Walk the list one page after another as long as its length is unknown
+    int maxParallel = total_ == NULL_ID ? 1 : maxParallel_;
+
+    while( inFlight_ < maxParallel )
+    {
+        if( end_ != NULL_ID && offset_ >= end_ )
+            break;
+
+        if( total_ != NULL_ID && offset_ >= total_ )
+            break;
+
+        retrievePage( offset_ );
+        offset_ += pageSize_;
+    }
+
+    RETURN();
+}
+
+void
+IssueListLoader::flush()
+{
+    ENTER()(emitOffset_)(pages_.size());
+
+    while( loading_ && pages_.contains(emitOffset_) )
+    {
+        IssueStore::Block block = pages_.take( emitOffset_ );
+
+        bool first = emitOffset_ == 0;
+        emitOffset_ += pageSize_;
+
+        bool last = block.size() < pageSize_ || (total_ != NULL_ID && emitOffset_ >= total_);
+
+        // Issues that have already been handed out are rare, so remove them one by one
+        for( int row = 0; row < block.size(); )
+        {
+            int issueId = block.ids[row];
+
+            if( issueIds_.contains(issueId) )
+            {
+                block.remove( row );
+                continue;
+            }
+
+            issueIds_.insert( issueId );
+            ++row;
+        }
+
+        quint64 generation = generation_;
+
+        emit pageLoaded( block, first, issueIds_.size() );
+
+        // A slot might have started a new load or cancelled this one
+        if( generation != generation_ )
+            RETURN();
+
+        if( last )
+        {
+            loading_ = false;
+            pages_.clear();
+
+            emit finished( issueIds_.size() );
+        }
+    }
+
+    RETURN();
+}
+
+int
+IssueListLoader::loaded() const
+{
+    ENTER();
+    RETURN( issueIds_.size() );
+}
+
+bool
+IssueListLoader::loading() const
+{
+    ENTER();
+    RETURN( loading_ );
+}
+
+void
+IssueListLoader::retrievePage( int offset )
+{
+    ENTER()(parameters_)(offset)(pageSize_);
+
+    QString parameters = QString("%1&offset=%2&limit=%3").arg(parameters_).arg(offset).arg(pageSize_);
+
+    // The loader might be deleted before the reply arrives
+    QPointer<IssueListLoader> self( this );
+    quint64 generation = generation_;
+
+    ++inFlight_;
+
+    // Collect the issues while the page is arriving instead of decoding the whole response at once
+    auto issues = std::make_shared<Issues>();
+    issues->reserve( pageSize_ );
+
+    redmine_->streamIssues( [=]( const Issue& issue )
+    {
+        issues->push_back( issue );
+    },
+    [=]( int total, RedmineError redmineError, QStringList errors )
+    {
+        ENTER()(offset)(issues->size())(total)(redmineError)(errors);
+
+        if( !self || generation != generation_ || !loading_ )
+        {
+            DEBUG() << "Discarding page of outdated load";
+            RETURN();
+        }
+
+        --inFlight_;
+
+        if( redmineError != RedmineError::NO_ERR )
+        {
+            // Discard the remaining pages of this load
+            cancel();
+
+            emit failed( errors );
+            RETURN();
+        }
+
+        // Every page tells the number of issues, in case the count has not arrived yet
+        if( total_ == NULL_ID && total != NULL_ID )
+            total_ = total;
+
+        if( issues->size() < pageSize_ )
+        {
+            int end = offset + issues->size();
+            end_ = end_ == NULL_ID ? end : qMin( end_, end );
+        }
+
+        // Request further pages before handing out this one to overlap network and GUI work
+        dispatch();
+
+        // Encode the page for the issue store in a worker thread
+        auto watcher = new QFutureWatcher<IssueStore::Block>( this );
+        connect( watcher, &QFutureWatcher<IssueStore::Block>::finished, [=]()
+        {
+            ENTER()(offset);
+
+            watcher->deleteLater();
+
+            if( generation != generation_ || !loading_ )
+            {
+                DEBUG() << "Discarding page of outdated load";
+                RETURN();
+            }
+
+            pages_.insert( offset, watcher->result() );
+
+            flush();
+
+            RETURN();
+        } );
+
+        watcher->setFuture( QtConcurrent::run([issues]()
+        {
+            return IssueStore::encode( *issues );
+        }) );
+
+        RETURN();
+    },
+    parameters );
+
+    RETURN();
+}
+
+void
+IssueListLoader::setMaxParallel( int maxParallel )
+{
+    ENTER()(maxParallel);
+    maxParallel_ = qMax( 1, maxParallel );
+    RETURN();
+}
+
+void
+IssueListLoader::setPageSize( int pageSize )
+{
+    ENTER()(pageSize);
+    pageSize_ = qBound( 1, pageSize, 100 );
+    RETURN();
+}
+
+void
+IssueListLoader::start( const QString& parameters )
+{
+    ENTER()(parameters);
+
+    cancel();
+
+    parameters_ = parameters;
+    offset_ = 0;
+    emitOffset_ = 0;
+    total_ = NULL_ID;
+    end_ = NULL_ID;
+    issueIds_.clear();
+    loading_ = true;
+
+    // The loader might be deleted before the reply arrives
+    QPointer<IssueListLoader> self( this );
+    quint64 generation = generation_;
+
+    // Request the number of issues alongside the first page to fetch the remaining pages in parallel
+    redmine_->retrieveIssueCount( [=]( int total, RedmineError redmineError, QStringList errors )
+    {
+        ENTER()(total)(redmineError)(errors);
+
+        if( !self || generation != generation_ || !loading_ )
+            RETURN();
+
+        if( redmineError != RedmineError::NO_ERR )
+        {
+            DEBUG() << "Number of issues unknown, loading pages one after another";
+            RETURN();
+        }
+
+        total_ = total;
+
+        dispatch();
+        flush();
+
+        RETURN();
+    },
+    parameters_ );
+
+    dispatch();
+
+    RETURN();
+}
+
+} // redtimer
@@ -0,0 +1,84 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/IssueRegistry.h"
+#include "redtimer/Serialisation.h"
+
+#include <QDataStream>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+namespace {
+
+/**
+ * @brief Serialise an issue for comparison
+ */
+QByteArray
+serialise( const Issue& issue )
+{
+    QByteArray data;
+    QDataStream out( &data, QIODevice::WriteOnly );
+    out.setVersion( QDataStream::Qt_5_5 );
+    out << issue;
+    return data;
+}
+
+} // anonymous
+
+IssueRegistry::IssueRegistry( QObject* parent )
+    : QObject( parent )
+{}
+
+IssueHandle
+IssueRegistry::get( int issueId )
+{
+    ENTER()(issueId);
+
+    auto it = issues_.find( issueId );
+    if( it == issues_.end() )
+        RETURN( IssueHandle() );
+
+    IssueHandle issue = it->toStrongRef();
+
+    // Drop issues that are no longer in use
+    if( !issue )
+        issues_.erase( it );
+
+    RETURN( issue );
+}
+
+IssueHandle
+IssueRegistry::null()
+{
+    ENTER();
+
+    Issue issue;
+    issue.id = NULL_ID;
+
+    RETURN( IssueHandle::create(issue) );
+}
+
+IssueHandle
+IssueRegistry::update( const Issue& issue )
+{
+    ENTER()(issue.id);
+
+    if( issue.id == NULL_ID )
+        RETURN( IssueHandle::create(issue) );
+
+    IssueHandle previous = get( issue.id );
+
+    // Hand out the registered issue if nothing has changed
+    if( previous && serialise(*previous) == serialise(issue) )
+        RETURN( previous );
+
+    IssueHandle handle = IssueHandle::create( issue );
+    issues_.insert( issue.id, handle );
+
+    if( previous )
+        emit changed( handle );
+
+    RETURN( handle );
+}
+
+} // redtimer
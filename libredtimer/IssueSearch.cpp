@@ -0,0 +1,255 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/IssueSearch.h"
+
+#include <QFutureWatcher>
+#include <QtConcurrent>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+const int IssueSearch::DEBOUNCE_DELAY;
+
+IssueSearch::IssueSearch( QObject* parent )
+    : QObject( parent )
+{
+    ENTER();
+
+    debounceTimer_ = new QTimer( this );
+    debounceTimer_->setSingleShot( true );
+    debounceTimer_->setInterval( DEBOUNCE_DELAY );
+    connect( debounceTimer_, &QTimer::timeout, this, &IssueSearch::run );
+
+    RETURN();
+}
+
+void
+IssueSearch::add( const Issues& issues )
+{
+    ENTER()(issues.size());
+    add( IssueStore::encode(issues) );
+    RETURN();
+}
+
+void
+IssueSearch::add( const IssueStore::Block& block )
+{
+    ENTER()(block.size());
+
+    if( block.size() == 0 )
+        RETURN();
+
+    queued_.push_back( block );
+
+    // Only one worker at a time so that additions are applied in order
+    if( !indexing_ )
+        index();
+
+    RETURN();
+}
+
+void
+IssueSearch::clear()
+{
+    ENTER();
+
+    // Results of running workers are discarded
+    ++epoch_;
+    indexing_ = false;
+    queued_.clear();
+
+    index_.clear();
+    ++indexVersion_;
+    matchesValid_ = false;
+
+    RETURN();
+}
+
+void
+IssueSearch::index()
+{
+    ENTER()(queued_.size())(index_.size());
+
+    QVector<IssueStore::Block> blocks;
+    blocks.swap( queued_ );
+
+    int count = 0;
+    for( const auto& block : blocks )
+        count += block.size();
+
+    if( index_.size() + count < threshold_ )
+    {
+        for( const auto& block : blocks )
+            index_.add( block );
+        ++indexVersion_;
+        matchesValid_ = false;
+
+        if( !query_.isEmpty() )
+            debounceTimer_->start();
+
+        RETURN();
+    }
+
+    // Tokenise the new issues into an index of their own in a worker thread, which is then merged into the
+    // index. Adding to a copy of the index would copy all of its postings for every page of issues.
+    quint64 epoch = epoch_;
+
+    indexing_ = true;
+
+    auto watcher = new QFutureWatcher<IssueIndex>( this );
+    connect( watcher, &QFutureWatcher<IssueIndex>::finished, [=]()
+    {
+        indexed( epoch, watcher->result() );
+        watcher->deleteLater();
+    } );
+
+    watcher->setFuture( QtConcurrent::run([=]()
+    {
+        IssueIndex index;
+        for( const auto& block : blocks )
+            index.add( block );
+        return index;
+    }) );
+
+    RETURN();
+}
+
+void
+IssueSearch::indexed( quint64 epoch, const IssueIndex& index )
+{
+    ENTER()(epoch)(index.size());
+
+    if( epoch != epoch_ )
+    {
+        DEBUG() << "Discarding index of cleared issues";
+        RETURN();
+    }
+
+    indexing_ = false;
+
+    index_.merge( index );
+    ++indexVersion_;
+
+    // New issues might match queries that did not match before
+    matchesValid_ = false;
+
+    if( !queued_.isEmpty() )
+        index();
+
+    // Include the new issues in the results of the latest query
+    if( !query_.isEmpty() )
+        debounceTimer_->start();
+
+    RETURN();
+}
+
+void
+IssueSearch::found( quint64 generation, quint64 indexVersion, const QString& query,
+                    const QVector<int>& issueIds )
+{
+    ENTER()(generation)(indexVersion)(query)(issueIds.size());
+
+    if( generation != generation_ )
+    {
+        DEBUG() << "Discarding result of outdated query";
+        RETURN();
+    }
+
+    matches_.clear();
+    matches_.reserve( issueIds.size() );
+    for( const auto& issueId : issueIds )
+        matches_.insert( issueId );
+
+    matchesQuery_ = query;
+    matchesValid_ = indexVersion == indexVersion_;
+
+    emit finished( issueIds );
+
+    RETURN();
+}
+
+void
+IssueSearch::run()
+{
+    ENTER()(query_);
+
+    quint64 generation = ++generation_;
+    quint64 indexVersion = indexVersion_;
+    QString query = query_;
+
+    // Adding to a query can only remove matches, so only search the previous matches again
+    bool narrow = matchesValid_ && query.startsWith(matchesQuery_);
+    DEBUG()(narrow)(matches_.size());
+
+    if( narrow && matches_.isEmpty() )
+    {
+        found( generation, indexVersion, query, QVector<int>() );
+        RETURN();
+    }
+
+    if( index_.size() < threshold_ )
+    {
+        found( generation, indexVersion, query, index_.search(query, narrow ? &matches_ : nullptr) );
+        RETURN();
+    }
+
+    // Search a snapshot in a worker thread, copying is cheap because of implicit sharing
+    IssueIndex index = index_;
+    QSet<int> candidates = narrow ? matches_ : QSet<int>();
+
+    auto watcher = new QFutureWatcher<QVector<int>>( this );
+    connect( watcher, &QFutureWatcher<QVector<int>>::finished, [=]()
+    {
+        found( generation, indexVersion, query, watcher->result() );
+        watcher->deleteLater();
+    } );
+
+    watcher->setFuture( QtConcurrent::run([=]()
+    {
+        return index.search( query, narrow ? &candidates : nullptr );
+    }) );
+
+    RETURN();
+}
+
+void
+IssueSearch::search( const QString& query )
+{
+    ENTER()(query);
+
+    if( query.trimmed().isEmpty() )
+    {
+        // Discard pending and running searches
+        debounceTimer_->stop();
+        ++generation_;
+
+        query_.clear();
+        matchesValid_ = false;
+
+        emit cleared();
+        RETURN();
+    }
+
+    query_ = query;
+    debounceTimer_->start();
+
+    RETURN();
+}
+
+void
+IssueSearch::setDelay( int delay )
+{
+    ENTER()(delay);
+    debounceTimer_->setInterval( qMax(0, delay) );
+    RETURN();
+}
+
+void
+IssueSearch::setThreshold( int threshold )
+{
+    ENTER()(threshold);
+    threshold_ = threshold;
+    RETURN();
+}
+
+} // redtimer
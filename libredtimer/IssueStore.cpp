@@ -0,0 +1,473 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/IssueStore.h"
+#include "redtimer/Serialisation.h"
+#include "redtimer/StringPool.h"
+
+#include <QDataStream>
+
+#include <algorithm>
+#include <limits>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+const int IssueStore::COMPRESS_THRESHOLD;
+
+namespace {
+
+/// Tags of the encoded descriptions
+const char RAW_TAG = 'r';
+const char COMPRESSED_TAG = 'z';
+
+/// Encoded invalid time
+const qint64 INVALID_TIME = std::numeric_limits<qint64>::min();
+
+/**
+ * @brief Insert values into a column
+ */
+template<typename T>
+void
+insertColumn( QVector<T>& column, int row, const QVector<T>& values )
+{
+    if( row == column.size() )
+    {
+        column += values;
+        return;
+    }
+
+    column.insert( row, values.size(), T() );
+    std::copy( values.begin(), values.end(), column.begin() + row );
+}
+
+/**
+ * @brief Copy an item into an item field
+ */
+void
+setItem( Item& target, const Item& source )
+{
+    target.id = source.id;
+    target.name = source.name;
+}
+
+/**
+ * @brief Encode a time
+ */
+qint64
+encodeTime( const QDateTime& time )
+{
+    return time.isValid() ? time.toMSecsSinceEpoch() : INVALID_TIME;
+}
+
+/**
+ * @brief Decode a time
+ */
+QDateTime
+decodeTime( qint64 time )
+{
+    return time == INVALID_TIME ? QDateTime() : QDateTime::fromMSecsSinceEpoch( time, Qt::UTC );
+}
+
+/**
+ * @brief Decode custom fields
+ */
+CustomFields
+decodeCustomFields( const QByteArray& data )
+{
+    CustomFields customFields;
+
+    if( data.isEmpty() )
+        return customFields;
+
+    QDataStream in( data );
+    in.setVersion( QDataStream::Qt_5_5 );
+    in >> customFields;
+
+    return customFields;
+}
+
+/**
+ * @brief Decode a description
+ */
+QString
+decodeDescription( const QByteArray& data )
+{
+    if( data.isEmpty() )
+        return QString();
+
+    if( data.at(0) == COMPRESSED_TAG )
+        return QString::fromUtf8( qUncompress(data.mid(1)) );
+
+    return QString::fromUtf8( data.constData() + 1, data.size() - 1 );
+}
+
+} // anonymous
+
+CustomFields
+IssueStore::Block::customFields( int row ) const
+{
+    return decodeCustomFields( customFields[row] );
+}
+
+QString
+IssueStore::Block::description( int row ) const
+{
+    return decodeDescription( descriptions[row] );
+}
+
+void
+IssueStore::Block::remove( int row )
+{
+    ids.remove( row );
+    parentIds.remove( row );
+    doneRatios.remove( row );
+    estimatedHours.remove( row );
+    subjects.remove( row );
+    texts.remove( row );
+    createdOn.remove( row );
+    updatedOn.remove( row );
+    startDates.remove( row );
+    dueDates.remove( row );
+    for( auto& column : items )
+        column.remove( row );
+    descriptions.remove( row );
+    customFields.remove( row );
+}
+
+int
+IssueStore::Block::size() const
+{
+    return ids.size();
+}
+
+void
+IssueStore::append( const Block& block )
+{
+    ENTER()(block.size());
+    insert( size(), block );
+    RETURN();
+}
+
+void
+IssueStore::append( const Issues& issues )
+{
+    ENTER()(issues.size());
+    insert( size(), issues );
+    RETURN();
+}
+
+Issue
+IssueStore::at( int row ) const
+{
+    ENTER()(row);
+
+    Issue issue;
+    issue.id = ids_[row];
+    issue.parentId = parentIds_[row];
+    issue.subject = subjects_[row];
+    issue.description = description( row );
+    issue.doneRatio = doneRatios_[row];
+    issue.estimatedHours = estimatedHours_[row];
+
+    setItem( issue.assignedTo, item(AssignedTo, row) );
+    setItem( issue.author, item(Author, row) );
+    setItem( issue.category, item(Category, row) );
+    setItem( issue.priority, item(Priority, row) );
+    setItem( issue.project, item(Project, row) );
+    setItem( issue.status, item(Status, row) );
+    setItem( issue.tracker, item(Tracker, row) );
+    setItem( issue.version, item(Version, row) );
+
+    issue.createdOn = createdOn( row );
+    issue.updatedOn = updatedOn( row );
+    issue.startDate = startDate( row );
+    issue.dueDate = dueDate( row );
+    issue.customFields = customFields( row );
+
+    RETURN( issue );
+}
+
+void
+IssueStore::clear()
+{
+    ENTER();
+
+    ids_.clear();
+    parentIds_.clear();
+    doneRatios_.clear();
+    estimatedHours_.clear();
+    subjects_.clear();
+    texts_.clear();
+    createdOn_.clear();
+    updatedOn_.clear();
+    startDates_.clear();
+    dueDates_.clear();
+    for( auto& column : items_ )
+        column.clear();
+    descriptions_.clear();
+    customFields_.clear();
+
+    itemTable_.clear();
+    itemLookup_.clear();
+
+    RETURN();
+}
+
+QDateTime
+IssueStore::createdOn( int row ) const
+{
+    return decodeTime( createdOn_[row] );
+}
+
+CustomFields
+IssueStore::customFields( int row ) const
+{
+    return decodeCustomFields( customFields_[row] );
+}
+
+QString
+IssueStore::description( int row ) const
+{
+    return decodeDescription( descriptions_[row] );
+}
+
+int
+IssueStore::doneRatio( int row ) const
+{
+    return doneRatios_[row];
+}
+
+QDate
+IssueStore::dueDate( int row ) const
+{
+    return QDate::fromJulianDay( dueDates_[row] );
+}
+
+IssueStore::Block
+IssueStore::encode( const Issues& issues )
+{
+    int count = issues.size();
+
+    Block block;
+    block.ids.reserve( count );
+    block.parentIds.reserve( count );
+    block.doneRatios.reserve( count );
+    block.estimatedHours.reserve( count );
+    block.subjects.reserve( count );
+    block.texts.reserve( count );
+    block.createdOn.reserve( count );
+    block.updatedOn.reserve( count );
+    block.startDates.reserve( count );
+    block.dueDates.reserve( count );
+    for( auto& column : block.items )
+        column.reserve( count );
+    block.descriptions.reserve( count );
+    block.customFields.reserve( count );
+
+    for( const auto& issue : issues )
+    {
+        block.ids.push_back( issue.id );
+        block.parentIds.push_back( issue.parentId );
+        block.doneRatios.push_back( static_cast<qint8>(issue.doneRatio) );
+        block.estimatedHours.push_back( issue.estimatedHours );
+        block.subjects.push_back( issue.subject );
+        block.texts.push_back( QString("#%1: %2").arg(issue.id).arg(issue.subject) );
+        block.createdOn.push_back( encodeTime(issue.createdOn) );
+        block.updatedOn.push_back( encodeTime(issue.updatedOn) );
+        block.startDates.push_back( issue.startDate.toJulianDay() );
+        block.dueDates.push_back( issue.dueDate.toJulianDay() );
+
+        block.items[AssignedTo].push_back( issue.assignedTo );
+        block.items[Author].push_back( issue.author );
+        block.items[Category].push_back( issue.category );
+        block.items[Priority].push_back( issue.priority );
+        block.items[Project].push_back( issue.project );
+        block.items[Status].push_back( issue.status );
+        block.items[Tracker].push_back( issue.tracker );
+        block.items[Version].push_back( issue.version );
+
+        QByteArray description;
+        if( !issue.description.isEmpty() )
+        {
+            QByteArray utf8 = issue.description.toUtf8();
+            if( utf8.size() >= COMPRESS_THRESHOLD )
+                description = COMPRESSED_TAG + qCompress( utf8 );
+            else
+                description = RAW_TAG + utf8;
+        }
+        block.descriptions.push_back( description );
+
+        QByteArray customFieldData;
+        if( !issue.customFields.isEmpty() )
+        {
+            QDataStream out( &customFieldData, QIODevice::WriteOnly );
+            out.setVersion( QDataStream::Qt_5_5 );
+            out << issue.customFields;
+        }
+        block.customFields.push_back( customFieldData );
+    }
+
+    return block;
+}
+
+double
+IssueStore::estimatedHours( int row ) const
+{
+    return estimatedHours_[row];
+}
+
+int
+IssueStore::id( int row ) const
+{
+    return ids_[row];
+}
+
+void
+IssueStore::insert( int row, const Block& block )
+{
+    ENTER()(row)(block.size());
+
+    if( block.size() == 0 )
+        RETURN();
+
+    // Only interning the items depends on the store, everything else has been encoded beforehand
+    QVector<int> items[FIELD_COUNT];
+    for( int field = 0; field < FIELD_COUNT; ++field )
+    {
+        items[field].reserve( block.size() );
+        for( const auto& item : block.items[field] )
+            items[field].push_back( intern(item) );
+    }
+
+    insertColumn( ids_, row, block.ids );
+    insertColumn( parentIds_, row, block.parentIds );
+    insertColumn( doneRatios_, row, block.doneRatios );
+    insertColumn( estimatedHours_, row, block.estimatedHours );
+    insertColumn( subjects_, row, block.subjects );
+    insertColumn( texts_, row, block.texts );
+    insertColumn( createdOn_, row, block.createdOn );
+    insertColumn( updatedOn_, row, block.updatedOn );
+    insertColumn( startDates_, row, block.startDates );
+    insertColumn( dueDates_, row, block.dueDates );
+    for( int field = 0; field < FIELD_COUNT; ++field )
+        insertColumn( items_[field], row, items[field] );
+    insertColumn( descriptions_, row, block.descriptions );
+    insertColumn( customFields_, row, block.customFields );
+
+    RETURN();
+}
+
+void
+IssueStore::insert( int row, const Issues& issues )
+{
+    ENTER()(row)(issues.size());
+    insert( row, encode(issues) );
+    RETURN();
+}
+
+int
+IssueStore::intern( const Item& item )
+{
+    StringPool& pool = StringPool::instance();
+
+    int nameId = pool.id( item.name );
+    auto key = qMakePair( item.id, nameId );
+
+    auto it = itemLookup_.constFind( key );
+    if( it != itemLookup_.constEnd() )
+        return it.value();
+
+    Item interned;
+    interned.id = item.id;
+    interned.name = pool.string( nameId );
+
+    itemTable_.push_back( interned );
+    itemLookup_.insert( key, itemTable_.size() - 1 );
+
+    return itemTable_.size() - 1;
+}
+
+Issues
+IssueStore::issues() const
+{
+    ENTER();
+
+    Issues issues;
+    issues.reserve( size() );
+    for( int row = 0; row < size(); ++row )
+        issues.push_back( at(row) );
+
+    RETURN( issues );
+}
+
+const Item&
+IssueStore::item( Field field, int row ) const
+{
+    return itemTable_[items_[field][row]];
+}
+
+void
+IssueStore::remove( int row, int count )
+{
+    ENTER()(row)(count);
+
+    ids_.remove( row, count );
+    parentIds_.remove( row, count );
+    doneRatios_.remove( row, count );
+    estimatedHours_.remove( row, count );
+    subjects_.remove( row, count );
+    texts_.remove( row, count );
+    createdOn_.remove( row, count );
+    updatedOn_.remove( row, count );
+    startDates_.remove( row, count );
+    dueDates_.remove( row, count );
+    for( auto& column : items_ )
+        column.remove( row, count );
+    descriptions_.remove( row, count );
+    customFields_.remove( row, count );
+
+    RETURN();
+}
+
+void
+IssueStore::replace( int row, const Issue& issue )
+{
+    ENTER()(row)(issue.id);
+
+    remove( row, 1 );
+    insert( row, Issues{issue} );
+
+    RETURN();
+}
+
+int
+IssueStore::size() const
+{
+    return ids_.size();
+}
+
+QDate
+IssueStore::startDate( int row ) const
+{
+    return QDate::fromJulianDay( startDates_[row] );
+}
+
+const QString&
+IssueStore::subject( int row ) const
+{
+    return subjects_[row];
+}
+
+const QString&
+IssueStore::text( int row ) const
+{
+    return texts_[row];
+}
+
+QDateTime
+IssueStore::updatedOn( int row ) const
+{
+    return decodeTime( updatedOn_[row] );
+}
+
+} // redtimer
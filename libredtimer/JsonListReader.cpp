@@ -0,0 +1,213 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/JsonListReader.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonParseError>
+
+namespace redtimer {
+
+JsonListReader::JsonListReader( const QString& listKey, RecordCb callback )
+    : listKey_( listKey.toUtf8() ),
+      callback_( callback )
+{}
+
+bool
+JsonListReader::atEnd() const
+{
+    ENTER();
+    RETURN( atEnd_ );
+}
+
+bool
+JsonListReader::feed( const QByteArray& data )
+{
+    if( error_ )
+        return false;
+
+    // Start of the captured part of this chunk
+    int from = 0;
+
+    for( int i = 0; i < data.size(); ++i )
+    {
+        char c = data.at( i );
+
+        if( inString_ )
+        {
+            if( escape_ )
+                escape_ = false;
+            else if( c == '\\' )
+                escape_ = true;
+            else if( c == '"' )
+            {
+                inString_ = false;
+
+                if( capture_ == Capture::Key )
+                {
+                    buffer_.append( data.constData() + from, i - from );
+                    finishCapture();
+                }
+            }
+
+            continue;
+        }
+
+        // Skip whitespace between tokens
+        if( c == ' ' || c == '\n' || c == '\r' || c == '\t' )
+            continue;
+
+        // Top-level scalar values end at the next separator
+        if( capture_ == Capture::Scalar && depth_ == 1 && (c == ',' || c == '}') )
+        {
+            buffer_.append( data.constData() + from, i - from );
+            finishCapture();
+        }
+
+        if( depth_ == 1 && expectValue_ && c != ':' )
+        {
+            expectValue_ = false;
+
+            if( c == '[' && key_ == listKey_ )
+                inList_ = true;
+            else if( c != '{' && c != '[' )
+            {
+                capture_ = Capture::Scalar;
+                from = i;
+            }
+        }
+
+        switch( c )
+        {
+        case '"':
+            inString_ = true;
+
+            if( depth_ == 1 && expectKey_ )
+            {
+                expectKey_ = false;
+                capture_ = Capture::Key;
+                from = i + 1;
+            }
+            break;
+
+        case '{':
+        case '[':
+            if( inList_ && depth_ == 2 && c == '{' )
+            {
+                capture_ = Capture::Record;
+                from = i;
+            }
+
+            if( ++depth_ == 1 )
+                expectKey_ = c == '{';
+            break;
+
+        case '}':
+        case ']':
+            if( --depth_ < 0 )
+            {
+                error_ = true;
+                return false;
+            }
+
+            if( depth_ == 0 )
+                atEnd_ = true;
+            else if( depth_ == 1 )
+                inList_ = false;
+            else if( depth_ == 2 && capture_ == Capture::Record )
+            {
+                buffer_.append( data.constData() + from, i - from + 1 );
+                finishCapture();
+            }
+            break;
+
+        case ',':
+            if( depth_ == 1 )
+                expectKey_ = true;
+            break;
+
+        case ':':
+            if( depth_ == 1 )
+                expectValue_ = true;
+            break;
+
+        default:
+            break;
+        }
+
+        if( error_ )
+            return false;
+    }
+
+    // Keep the captured part of this chunk for the next one
+    if( capture_ != Capture::None )
+        buffer_.append( data.constData() + from, data.size() - from );
+
+    return true;
+}
+
+void
+JsonListReader::finishCapture()
+{
+    switch( capture_ )
+    {
+    case Capture::Key:
+        key_ = buffer_;
+        break;
+
+    case Capture::Scalar:
+        values_.insert( key_, buffer_.trimmed() );
+        break;
+
+    case Capture::Record:
+    {
+        QJsonParseError parseError;
+        QJsonDocument record = QJsonDocument::fromJson( buffer_, &parseError );
+
+        if( parseError.error != QJsonParseError::NoError || !record.isObject() )
+        {
+            error_ = true;
+            break;
+        }
+
+        ++records_;
+        callback_( record.object() );
+        break;
+    }
+
+    case Capture::None:
+        break;
+    }
+
+    capture_ = Capture::None;
+    buffer_.clear();
+}
+
+bool
+JsonListReader::hasError() const
+{
+    ENTER();
+    RETURN( error_ );
+}
+
+int
+JsonListReader::records() const
+{
+    ENTER();
+    RETURN( records_ );
+}
+
+QJsonValue
+JsonListReader::value( const QString& key ) const
+{
+    ENTER()(key);
+
+    auto it = values_.constFind( key.toUtf8() );
+    if( it == values_.constEnd() )
+        RETURN( QJsonValue(QJsonValue::Undefined) );
+
+    // Let QJsonDocument parse the scalar by wrapping it into an array
+    QJsonDocument document = QJsonDocument::fromJson( "[" + it.value() + "]" );
+    RETURN( document.array().at(0) );
+}
+
+} // redtimer
@@ -0,0 +1,370 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/MetadataCache.h"
+#include "redtimer/Serialisation.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+/// Magic number of the cache file
+#define METADATA_CACHE_MAGIC 0x52544d43 // "RTMC"
+
+namespace {
+
+/**
+ * @brief Serialise a list of items consisting of an ID and a name
+ */
+template<typename Container>
+QByteArray
+encode( const Container& items )
+{
+    QByteArray data;
+    QDataStream stream( &data, QIODevice::WriteOnly );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    stream << (qint32)items.size();
+    for( const auto& item : items )
+        stream << item.id << item.name;
+
+    return data;
+}
+
+/**
+ * @brief Serialise a list of custom fields
+ */
+QByteArray
+encode( const CustomFields& customFields )
+{
+    QByteArray data;
+    QDataStream stream( &data, QIODevice::WriteOnly );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    stream << (qint32)customFields.size();
+    for( const auto& customField : customFields )
+        stream << customField.id << customField.name << customField.format << customField.possibleValues;
+
+    return data;
+}
+
+/**
+ * @brief Deserialise a list of items consisting of an ID and a name
+ */
+template<typename Container>
+Container
+decode( const QByteArray& data, const Container* = nullptr )
+{
+    Container items;
+
+    QDataStream stream( data );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    qint32 size;
+    stream >> size;
+    for( qint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i )
+    {
+        typename Container::value_type item;
+        stream >> item.id >> item.name;
+        items.push_back( item );
+    }
+
+    return items;
+}
+
+/**
+ * @brief Deserialise a list of custom fields
+ */
+CustomFields
+decode( const QByteArray& data, const CustomFields* )
+{
+    CustomFields customFields;
+
+    QDataStream stream( data );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    qint32 size;
+    stream >> size;
+    for( qint32 i = 0; i < size && stream.status() == QDataStream::Ok; ++i )
+    {
+        CustomField customField;
+        stream >> customField.id >> customField.name >> customField.format >> customField.possibleValues;
+        customFields.push_back( customField );
+    }
+
+    return customFields;
+}
+
+} // anonymous
+
+MetadataCache::MetadataCache( RedmineSession* redmine, QObject* parent )
+    : QObject( parent ),
+      redmine_( redmine )
+{}
+
+void
+MetadataCache::invalidate()
+{
+    ENTER();
+
+    for( auto& entry : entries_ )
+        entry.validated = QDateTime();
+
+    RETURN();
+}
+
+bool
+MetadataCache::load()
+{
+    ENTER()(fileName_);
+
+    entries_.clear();
+
+    QFile file( fileName_ );
+    if( !file.open(QIODevice::ReadOnly) )
+        RETURN( false );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    if( !readHeader(stream, METADATA_CACHE_MAGIC, VERSION, url_) )
+    {
+        DEBUG() << "Discarding outdated metadata cache";
+        RETURN( false );
+    }
+
+    qint32 count;
+    stream >> count;
+
+    for( qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i )
+    {
+        QString key;
+        Entry entry;
+        stream >> key >> entry.data >> entry.validated;
+        entries_.insert( key, entry );
+    }
+
+    if( stream.status() != QDataStream::Ok )
+    {
+        DEBUG() << "Metadata cache is corrupt";
+        entries_.clear();
+        RETURN( false );
+    }
+
+    DEBUG()(entries_.keys());
+
+    RETURN( true );
+}
+
+void
+MetadataCache::open( int profileId, const QString& url )
+{
+    ENTER()(profileId)(url);
+
+    QDir dir( QStandardPaths::writableLocation(QStandardPaths::CacheLocation) );
+    QString fileName = dir.filePath( QString("profile-%1/metadata.cache").arg(profileId) );
+
+    if( fileName == fileName_ && url == url_ )
+        RETURN();
+
+    fileName_ = fileName;
+    url_ = url;
+
+    load();
+
+    RETURN();
+}
+
+template<typename T>
+void
+MetadataCache::retrieve( const QString& key, std::function<void(RedmineCb<T>)> fetch, RedmineCb<T> cb )
+{
+    ENTER()(key);
+
+    auto it = entries_.constFind( key );
+
+    // Results for a URL that the cache is no longer bound to are not stored
+    QString url = url_;
+
+    // Not cached: retrieve from Redmine and return the result
+    if( it == entries_.constEnd() )
+    {
+        fetch( [=]( T result, RedmineError redmineError, QStringList errors )
+        {
+            ENTER()(key)(redmineError)(errors);
+
+            if( redmineError == RedmineError::NO_ERR && url == url_ )
+                update( key, encode(result) );
+
+            cb( result, redmineError, errors );
+
+            RETURN();
+        } );
+
+        RETURN();
+    }
+
+    // Cached: serve immediately
+    bool stale = !it->validated.isValid()
+                 || it->validated.secsTo( QDateTime::currentDateTimeUtc() ) > ttl_;
+
+    DEBUG()(stale);
+
+    cb( decode(it->data, (T*)nullptr), RedmineError::NO_ERR, QStringList() );
+
+    // Stale: revalidate in the background
+    if( !stale || revalidating_.contains(key) )
+        RETURN();
+
+    revalidating_.insert( key );
+
+    fetch( [=]( T result, RedmineError redmineError, QStringList errors )
+    {
+        ENTER()(key)(redmineError)(errors);
+
+        revalidating_.remove( key );
+
+        if( redmineError != RedmineError::NO_ERR || url != url_ )
+            RETURN();
+
+        if( update(key, encode(result)) )
+        {
+            DEBUG() << "Revalidated data have changed";
+            emit changed( key );
+        }
+
+        RETURN();
+    } );
+
+    RETURN();
+}
+
+void
+MetadataCache::retrieveCustomFields( RedmineCb<CustomFields> callback, const CustomFieldFilter& filter )
+{
+    ENTER();
+
+    QString key = QString("customFields/%1/%2/%3").arg(filter.type).arg(filter.format).arg(filter.projectId);
+
+    retrieve<CustomFields>( key, [=]( RedmineCb<CustomFields> cb )
+    {
+        redmine_->retrieveCustomFields( [=]( CustomFields customFields, RedmineError redmineError,
+                                             QStringList errors )
+        {
+            cb( customFields, redmineError, errors );
+        },
+        filter );
+    },
+    callback );
+
+    RETURN();
+}
+
+void
+MetadataCache::retrieveIssueStatuses( RedmineCb<IssueStatuses> callback )
+{
+    ENTER();
+
+    retrieve<IssueStatuses>( "issueStatuses", [=]( RedmineCb<IssueStatuses> cb )
+    {
+        redmine_->retrieveIssueStatuses( [=]( IssueStatuses issueStatuses, RedmineError redmineError,
+                                              QStringList errors )
+        {
+            cb( issueStatuses, redmineError, errors );
+        } );
+    },
+    callback );
+
+    RETURN();
+}
+
+void
+MetadataCache::retrieveTimeEntryActivities( RedmineCb<Enumerations> callback )
+{
+    ENTER();
+
+    retrieve<Enumerations>( "activities", [=]( RedmineCb<Enumerations> cb )
+    {
+        redmine_->retrieveTimeEntryActivities( [=]( Enumerations activities, RedmineError redmineError,
+                                                    QStringList errors )
+        {
+            cb( activities, redmineError, errors );
+        } );
+    },
+    callback );
+
+    RETURN();
+}
+
+void
+MetadataCache::retrieveTrackers( RedmineCb<Trackers> callback )
+{
+    ENTER();
+
+    retrieve<Trackers>( "trackers", [=]( RedmineCb<Trackers> cb )
+    {
+        redmine_->retrieveTrackers( [=]( Trackers trackers, RedmineError redmineError, QStringList errors )
+        {
+            cb( trackers, redmineError, errors );
+        } );
+    },
+    callback );
+
+    RETURN();
+}
+
+bool
+MetadataCache::save()
+{
+    ENTER()(fileName_);
+
+    if( fileName_.isEmpty() )
+        RETURN( false );
+
+    QDir().mkpath( QFileInfo(fileName_).absolutePath() );
+
+    QSaveFile file( fileName_ );
+    if( !file.open(QIODevice::WriteOnly) )
+        RETURN( false );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    writeHeader( stream, METADATA_CACHE_MAGIC, VERSION, url_ );
+    stream << (qint32)entries_.size();
+    for( auto it = entries_.constBegin(); it != entries_.constEnd(); ++it )
+        stream << it.key() << it->data << it->validated;
+
+    RETURN( file.commit() );
+}
+
+void
+MetadataCache::setTtl( int ttl )
+{
+    ENTER()(ttl);
+    ttl_ = ttl;
+    RETURN();
+}
+
+bool
+MetadataCache::update( const QString& key, const QByteArray& data )
+{
+    ENTER()(key);
+
+    Entry& entry = entries_[key];
+    bool changed = entry.data != data;
+
+    entry.data = data;
+    entry.validated = QDateTime::currentDateTimeUtc();
+
+    save();
+
+    RETURN( changed );
+}
+
+} // redtimer
@@ -0,0 +1,245 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/ProfileStore.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSettings>
+#include <QStandardPaths>
+
+namespace redtimer {
+
+/// Magic number of the profile index
+#define PROFILE_INDEX_MAGIC 0x52545049 // "RTPI"
+
+/// Magic number of a profile file
+#define PROFILE_STORE_MAGIC 0x52545053 // "RTPS"
+
+bool
+ProfileStore::addProfile( int id, const QString& name )
+{
+    ENTER()(id)(name);
+
+    Profiles all = profiles();
+
+    bool found = false;
+    for( auto& profile : all )
+    {
+        if( profile.id != id )
+            continue;
+
+        if( profile.name == name )
+            RETURN( true );
+
+        profile.name = name;
+        found = true;
+    }
+
+    if( !found )
+        all.push_back( Profile{id, name} );
+
+    RETURN( saveProfiles(all) );
+}
+
+QString
+ProfileStore::directory()
+{
+    QDir dir( QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) );
+    return dir.filePath( "Thomssen IT/RedTimer" );
+}
+
+QString
+ProfileStore::fileName( int profileId )
+{
+    return QDir( directory() ).filePath( QString("profile-%1.settings").arg(profileId) );
+}
+
+ProfileStore::Profiles
+ProfileStore::import()
+{
+    ENTER();
+
+    Profiles profiles;
+
+    QSettings settings( QSettings::IniFormat, QSettings::UserScope, "Thomssen IT", "RedTimer" );
+
+    for( const auto& group : settings.childGroups() )
+    {
+        QRegularExpressionMatch match = QRegularExpression("^profile-(\\d+)$").match( group );
+
+        // Not a profile group entry
+        if( !match.hasMatch() )
+            continue;
+
+        int profileId = match.captured(1).toInt();
+
+        Values values;
+        settings.beginGroup( group );
+        for( const auto& key : settings.allKeys() )
+            values.insert( key, settings.value(key) );
+        settings.endGroup();
+
+        save( profileId, values );
+        profiles.push_back( Profile{profileId, values.value("name").toString()} );
+    }
+
+    DEBUG() << "Imported" << profiles.size() << "profiles from" << settings.fileName();
+
+    RETURN( profiles );
+}
+
+QString
+ProfileStore::indexFileName()
+{
+    ENTER();
+    RETURN( QDir(directory()).filePath("profiles.index") );
+}
+
+bool
+ProfileStore::load( int profileId, Values* values )
+{
+    ENTER()(profileId);
+
+    values->clear();
+
+    QFile file( fileName(profileId) );
+    if( !file.open(QIODevice::ReadOnly) )
+        RETURN( false );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    quint32 magic;
+    quint32 version;
+    stream >> magic >> version;
+
+    if( magic != PROFILE_STORE_MAGIC || version != VERSION )
+    {
+        DEBUG() << "Discarding profile file with unknown format";
+        RETURN( false );
+    }
+
+    stream >> *values;
+
+    if( stream.status() != QDataStream::Ok )
+    {
+        DEBUG() << "Profile file is corrupt";
+        values->clear();
+        RETURN( false );
+    }
+
+    RETURN( true );
+}
+
+ProfileStore::Profiles
+ProfileStore::profiles()
+{
+    ENTER();
+
+    QFile file( indexFileName() );
+    if( !file.open(QIODevice::ReadOnly) )
+        RETURN( rebuildIndex() );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    quint32 magic;
+    quint32 version;
+    qint32 count;
+    stream >> magic >> version >> count;
+
+    if( magic != PROFILE_INDEX_MAGIC || version != VERSION )
+    {
+        DEBUG() << "Rebuilding profile index with unknown format";
+        RETURN( rebuildIndex() );
+    }
+
+    Profiles profiles;
+    for( qint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i )
+    {
+        Profile profile;
+        stream >> profile.id >> profile.name;
+        profiles.push_back( profile );
+    }
+
+    if( stream.status() != QDataStream::Ok )
+    {
+        DEBUG() << "Profile index is corrupt, rebuilding it";
+        RETURN( rebuildIndex() );
+    }
+
+    RETURN( profiles );
+}
+
+ProfileStore::Profiles
+ProfileStore::rebuildIndex()
+{
+    ENTER();
+
+    Profiles profiles;
+
+    QDir dir( directory() );
+    for( const auto& entry : dir.entryList(QStringList("profile-*.settings"), QDir::Files, QDir::Name) )
+    {
+        QRegularExpressionMatch match = QRegularExpression("^profile-(\\d+)\\.settings$").match( entry );
+
+        if( !match.hasMatch() )
+            continue;
+
+        int profileId = match.captured(1).toInt();
+
+        Values values;
+        if( load(profileId, &values) )
+            profiles.push_back( Profile{profileId, values.value("name").toString()} );
+    }
+
+    // Import the former settings file upon the first start
+    if( profiles.isEmpty() )
+        profiles = import();
+
+    saveProfiles( profiles );
+
+    RETURN( profiles );
+}
+
+bool
+ProfileStore::save( int profileId, const Values& values )
+{
+    QDir().mkpath( directory() );
+
+    QSaveFile file( fileName(profileId) );
+    if( !file.open(QIODevice::WriteOnly) )
+        return false;
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    stream << (quint32)PROFILE_STORE_MAGIC << VERSION << values;
+
+    return file.commit();
+}
+
+bool
+ProfileStore::saveProfiles( const Profiles& profiles )
+{
+    ENTER()(profiles.size());
+
+    QDir().mkpath( directory() );
+
+    QSaveFile file( indexFileName() );
+    if( !file.open(QIODevice::WriteOnly) )
+        RETURN( false );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    stream << (quint32)PROFILE_INDEX_MAGIC << VERSION << (qint32)profiles.size();
+    for( const auto& profile : profiles )
+        stream << (qint32)profile.id << profile.name;
+
+    RETURN( file.commit() );
+}
+
+} // redtimer
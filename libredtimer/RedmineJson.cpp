@@ -0,0 +1,114 @@
+#include "redtimer/RedmineJson.h"
+#include "redtimer/StringPool.h"
+
+#include <QJsonArray>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+namespace {
+
+/**
+ * @brief Convert a custom field value into a string without losing numbers
+ */
+QString
+valueString( const QJsonValue& value )
+{
+    if( value.isString() )
+        return value.toString();
+
+    // Numbers and booleans are converted like Redmine formats them, null becomes an empty string
+    return value.toVariant().toString();
+}
+
+} // anonymous
+
+void
+fromJson( const QJsonObject& object, Item& item )
+{
+    item.id = object.value("id").toInt( NULL_ID );
+    item.name = StringPool::instance().intern( object.value("name").toString() );
+}
+
+void
+fromJson( const QJsonObject& object, Issue& issue )
+{
+    issue.id = object.value("id").toInt( NULL_ID );
+    issue.parentId = object.value("parent").toObject().value("id").toInt( NULL_ID );
+    issue.subject = object.value("subject").toString();
+    issue.description = object.value("description").toString();
+    issue.doneRatio = object.value("done_ratio").toInt();
+    issue.estimatedHours = object.value("estimated_hours").toDouble();
+
+    fromJson( object.value("assigned_to").toObject(), issue.assignedTo );
+    fromJson( object.value("author").toObject(), issue.author );
+    fromJson( object.value("category").toObject(), issue.category );
+    fromJson( object.value("priority").toObject(), issue.priority );
+    fromJson( object.value("project").toObject(), issue.project );
+    fromJson( object.value("status").toObject(), issue.status );
+    fromJson( object.value("tracker").toObject(), issue.tracker );
+    fromJson( object.value("fixed_version").toObject(), issue.version );
+
+    issue.createdOn = QDateTime::fromString( object.value("created_on").toString(), Qt::ISODate );
+    issue.updatedOn = QDateTime::fromString( object.value("updated_on").toString(), Qt::ISODate );
+    issue.startDate = QDate::fromString( object.value("start_date").toString(), Qt::ISODate );
+    issue.dueDate = QDate::fromString( object.value("due_date").toString(), Qt::ISODate );
+
+    issue.customFields.clear();
+    for( const auto& value : object.value("custom_fields").toArray() )
+    {
+        QJsonObject field = value.toObject();
+
+        CustomField customField;
+        customField.id = field.value("id").toInt( NULL_ID );
+        customField.name = field.value("name").toString();
+
+        // Multiple value fields contain an array
+        QJsonValue values = field.value("value");
+        if( values.isArray() )
+        {
+            for( const auto& v : values.toArray() )
+                customField.values.append( valueString(v) );
+        }
+        else
+            customField.values.append( valueString(values) );
+
+        issue.customFields.push_back( customField );
+    }
+}
+
+QJsonObject
+toJson( const TimeEntry& timeEntry )
+{
+    QJsonObject object;
+    object["issue_id"] = timeEntry.issue.id;
+    object["spent_on"] = timeEntry.spentOn.toString( Qt::ISODate );
+    object["hours"] = timeEntry.hours;
+    object["comments"] = timeEntry.comment;
+
+    if( timeEntry.activity.id != NULL_ID )
+        object["activity_id"] = timeEntry.activity.id;
+
+    QJsonArray customFields;
+    for( const auto& customField : timeEntry.customFields )
+    {
+        QJsonObject field;
+        field["id"] = customField.id;
+
+        // Multiple value fields expect an array
+        if( customField.values.size() == 1 )
+            field["value"] = customField.values.first();
+        else
+            field["value"] = QJsonArray::fromStringList( customField.values );
+
+        customFields.append( field );
+    }
+
+    if( !customFields.isEmpty() )
+        object["custom_fields"] = customFields;
+
+    return object;
+}
+
+} // redtimer
@@ -0,0 +1,686 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/JsonListReader.h"
+#include "redtimer/RedmineJson.h"
+#include "redtimer/RedmineSession.h"
+
+#include <QFutureWatcher>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkReply>
+#include <QPair>
+#include <QtConcurrent>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+namespace {
+
+/**
+ * @brief Streamed list response that is decoded in worker threads
+ *
+ * The bytes of the response are handed to a worker thread as they arrive, one chunk after the other. The
+ * worker parses and decodes the complete records, which are then handed out in the thread of the session.
+ */
+template<typename T>
+struct Stream : public std::enable_shared_from_this<Stream<T>>
+{
+    /// Reader, only used by the worker decoding the current chunk
+    std::unique_ptr<JsonListReader> reader;
+
+    /// Records decoded by the current worker
+    QVector<T> decoded;
+
+    /// Decode a record
+    std::function<T(const QJsonObject&)> decode;
+
+    /// Callback for each record
+    std::function<void(const T&)> record;
+
+    /// Callback upon completion
+    RedmineCb<int> callback;
+
+    /// Parent of the future watchers
+    QObject* context = nullptr;
+
+    /// Bytes that have not been handed to a worker yet
+    QByteArray queued;
+
+    /// A worker is decoding a chunk
+    bool decoding = false;
+
+    /// The reply has finished
+    bool finished = false;
+
+    /// Error message of the reply, empty if there was no error
+    QString error;
+
+    /**
+     * @brief Hand the queued bytes to a worker, or complete once all bytes have been decoded
+     */
+    void pump()
+    {
+        if( decoding )
+            return;
+
+        if( queued.isEmpty() )
+        {
+            if( finished )
+                complete();
+
+            return;
+        }
+
+        QByteArray chunk;
+        chunk.swap( queued );
+        decoding = true;
+
+        auto self = this->shared_from_this();
+
+        auto watcher = new QFutureWatcher<QVector<T>>( context );
+        QObject::connect( watcher, &QFutureWatcher<QVector<T>>::finished, [=]()
+        {
+            for( const auto& item : watcher->result() )
+                self->record( item );
+
+            watcher->deleteLater();
+
+            self->decoding = false;
+            self->pump();
+        } );
+
+        watcher->setFuture( QtConcurrent::run([=]()
+        {
+            self->reader->feed( chunk );
+
+            QVector<T> items;
+            items.swap( self->decoded );
+            return items;
+        }) );
+    }
+
+    /**
+     * @brief Report the result once the response has been decoded completely
+     */
+    void complete()
+    {
+        ENTER()(reader->records())(error);
+
+        if( !error.isEmpty() || reader->hasError() || !reader->atEnd() )
+        {
+            callback( NULL_ID, RedmineError::ERR_INCOMPLETE_DATA, QStringList(error) );
+            RETURN();
+        }
+
+        callback( reader->value("total_count").toInt(NULL_ID), RedmineError::NO_ERR, QStringList() );
+
+        RETURN();
+    }
+};
+
+} // anonymous
+
+RedmineSession::RedmineSession( QObject* parent )
+    : SimpleRedmineClient( parent )
+{}
+
+quint64
+RedmineSession::coalescedRequests() const
+{
+    ENTER();
+    RETURN( coalesced_ );
+}
+
+quint64
+RedmineSession::sentRequests() const
+{
+    ENTER();
+    RETURN( sent_ );
+}
+
+template<typename T>
+void
+RedmineSession::coalesce( const QString& key, RedmineCb<T> callback, std::function<void(RedmineCb<T>)> send )
+{
+    ENTER()(key);
+
+    auto it = inFlight_.find( key );
+    if( it != inFlight_.end() )
+    {
+        ++coalesced_;
+        DEBUG() << "Attaching to in-flight request";
+        DEBUG()(sent_)(coalesced_);
+
+        static_cast<Pending<T>*>( it->get() )->callbacks.push_back( callback );
+        RETURN();
+    }
+
+    auto pending = std::make_shared<Pending<T>>();
+    pending->callbacks.push_back( callback );
+    inFlight_.insert( key, pending );
+
+    ++sent_;
+    DEBUG()(sent_)(coalesced_);
+
+    send( [=]( T result, RedmineError redmineError, QStringList errors )
+    {
+        ENTER()(key)(pending->callbacks.size())(redmineError)(errors);
+
+        // Remove the request first so that the callbacks may issue it again; the session might have been
+        // switched to another server in the meantime
+        if( inFlight_.value(key) == pending )
+            inFlight_.remove( key );
+
+        for( const auto& cb : pending->callbacks )
+            cb( result, redmineError, errors );
+
+        RETURN();
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveCurrentUser( RedmineCb<User> callback )
+{
+    ENTER();
+
+    coalesce<User>( "users/current", callback, [=]( RedmineCb<User> cb )
+    {
+        SimpleRedmineClient::retrieveCurrentUser( [=]( User user, RedmineError redmineError,
+                                                       QStringList errors )
+        {
+            cb( user, redmineError, errors );
+        } );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveCustomFields( RedmineCb<CustomFields> callback, const CustomFieldFilter& filter )
+{
+    ENTER()(filter.type)(filter.format)(filter.projectId);
+
+    QString key = QString("custom_fields?type=%1&format=%2&project_id=%3")
+                      .arg(filter.type).arg(filter.format).arg(filter.projectId);
+
+    coalesce<CustomFields>( key, callback, [=]( RedmineCb<CustomFields> cb )
+    {
+        SimpleRedmineClient::retrieveCustomFields( [=]( CustomFields customFields, RedmineError redmineError,
+                                                        QStringList errors )
+        {
+            cb( customFields, redmineError, errors );
+        },
+        filter );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveIssue( RedmineStatusCb<Issue> callback, int issueId )
+{
+    ENTER()(issueId);
+
+    QString key = QString("issues/%1").arg(issueId);
+
+    // The HTTP status code is shared with all callbacks of the request along with the issue
+    using Result = QPair<Issue, int>;
+
+    auto resultCb = [=]( Result result, RedmineError redmineError, QStringList errors )
+    {
+        callback( result.first, redmineError, result.second, errors );
+    };
+
+    coalesce<Result>( key, resultCb, [=]( RedmineCb<Result> cb )
+    {
+        // Decode the issue like streamed issues so that both compare equal
+        sendRequest( key, [=]( QNetworkReply* reply, QJsonDocument* json )
+        {
+            ENTER();
+
+            int status = reply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+
+            if( reply->error() != QNetworkReply::NoError )
+            {
+                QStringList errors;
+                if( json && json->isObject() )
+                {
+                    for( const auto& error : json->object().value("errors").toArray() )
+                        errors.append( error.toString() );
+                }
+
+                errors.append( reply->errorString() );
+
+                DEBUG()(status)(errors);
+
+                cb( Result(Issue(), status), RedmineError::ERR_INCOMPLETE_DATA, errors );
+                RETURN();
+            }
+
+            if( !json || !json->isObject() || !json->object().value("issue").isObject() )
+            {
+                cb( Result(Issue(), status), RedmineError::ERR_INCOMPLETE_DATA,
+                    QStringList("Malformed issue response") );
+                RETURN();
+            }
+
+            Issue issue;
+            fromJson( json->object().value("issue").toObject(), issue );
+            cb( Result(issue, status), RedmineError::NO_ERR, QStringList() );
+
+            RETURN();
+        } );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveIssueCount( RedmineCb<int> callback, const QString& parameters )
+{
+    ENTER()(parameters);
+
+    QString key = QString("issues/count?%1").arg(parameters);
+
+    coalesce<int>( key, callback, [=]( RedmineCb<int> cb )
+    {
+        QString query = parameters.isEmpty() ? QString("limit=1") : QString("%1&limit=1").arg(parameters);
+
+        // SimpleRedmineClient does not hand out the total count, so parse the reply here
+        sendRequest( "issues", [=]( QNetworkReply* reply, QJsonDocument* json )
+        {
+            ENTER();
+
+            if( reply->error() != QNetworkReply::NoError || !json || !json->isObject()
+                || !json->object().contains("total_count") )
+            {
+                cb( NULL_ID, RedmineError::ERR_INCOMPLETE_DATA, QStringList(reply->errorString()) );
+                RETURN();
+            }
+
+            cb( json->object().value("total_count").toInt(), RedmineError::NO_ERR, QStringList() );
+
+            RETURN();
+        },
+        QNetworkAccessManager::GetOperation, query );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveIssueStatuses( RedmineCb<IssueStatuses> callback )
+{
+    ENTER();
+
+    coalesce<IssueStatuses>( "issue_statuses", callback, [=]( RedmineCb<IssueStatuses> cb )
+    {
+        SimpleRedmineClient::retrieveIssueStatuses( [=]( IssueStatuses issueStatuses,
+                                                         RedmineError redmineError, QStringList errors )
+        {
+            cb( issueStatuses, redmineError, errors );
+        } );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveMemberships( RedmineCb<Memberships> callback, int projectId, const QString& parameters )
+{
+    ENTER()(projectId)(parameters);
+
+    QString key = QString("projects/%1/memberships?%2").arg(projectId).arg(parameters);
+
+    coalesce<Memberships>( key, callback, [=]( RedmineCb<Memberships> cb )
+    {
+        SimpleRedmineClient::retrieveMemberships( [=]( Memberships memberships, RedmineError redmineError,
+                                                       QStringList errors )
+        {
+            cb( memberships, redmineError, errors );
+        },
+        projectId, parameters );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveProject( RedmineCb<Project> callback, int projectId )
+{
+    ENTER()(projectId);
+
+    QString key = QString("projects/%1").arg(projectId);
+
+    coalesce<Project>( key, callback, [=]( RedmineCb<Project> cb )
+    {
+        SimpleRedmineClient::retrieveProject( [=]( Project project, RedmineError redmineError,
+                                                   QStringList errors )
+        {
+            cb( project, redmineError, errors );
+        },
+        projectId );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveProjects( RedmineCb<Projects> callback, const QString& parameters )
+{
+    ENTER()(parameters);
+
+    QString key = QString("projects?%1").arg(parameters);
+
+    coalesce<Projects>( key, callback, [=]( RedmineCb<Projects> cb )
+    {
+        SimpleRedmineClient::retrieveProjects( [=]( Projects projects, RedmineError redmineError,
+                                                    QStringList errors )
+        {
+            cb( projects, redmineError, errors );
+        },
+        parameters );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveQueries( RedmineCb<SavedQueries> callback, const QString& parameters )
+{
+    ENTER()(parameters);
+
+    QString key = QString("queries?%1").arg(parameters);
+
+    coalesce<SavedQueries>( key, callback, [=]( RedmineCb<SavedQueries> cb )
+    {
+        // SimpleRedmineClient does not know saved queries, so parse the reply here
+        sendRequest( "queries", [=]( QNetworkReply* reply, QJsonDocument* json )
+        {
+            ENTER();
+
+            SavedQueries queries;
+
+            if( reply->error() != QNetworkReply::NoError || !json || !json->isObject() )
+            {
+                cb( queries, RedmineError::ERR_INCOMPLETE_DATA, QStringList(reply->errorString()) );
+                RETURN();
+            }
+
+            for( const auto& value : json->object().value("queries").toArray() )
+            {
+                QJsonObject object = value.toObject();
+
+                SavedQuery query;
+                query.id = object.value("id").toInt( NULL_ID );
+                query.name = object.value("name").toString();
+                query.projectId = object.value("project_id").toInt( NULL_ID );
+
+                queries.push_back( query );
+            }
+
+            cb( queries, RedmineError::NO_ERR, QStringList() );
+
+            RETURN();
+        },
+        QNetworkAccessManager::GetOperation, parameters );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveTimeEntries( RedmineCb<TimeEntries> callback, const QString& parameters )
+{
+    ENTER()(parameters);
+
+    QString key = QString("time_entries?%1").arg(parameters);
+
+    coalesce<TimeEntries>( key, callback, [=]( RedmineCb<TimeEntries> cb )
+    {
+        SimpleRedmineClient::retrieveTimeEntries( [=]( TimeEntries timeEntries, RedmineError redmineError,
+                                                       QStringList errors )
+        {
+            cb( timeEntries, redmineError, errors );
+        },
+        parameters );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveTimeEntryActivities( RedmineCb<Enumerations> callback )
+{
+    ENTER();
+
+    coalesce<Enumerations>( "enumerations/time_entry_activities", callback, [=]( RedmineCb<Enumerations> cb )
+    {
+        SimpleRedmineClient::retrieveTimeEntryActivities( [=]( Enumerations activities,
+                                                               RedmineError redmineError, QStringList errors )
+        {
+            cb( activities, redmineError, errors );
+        } );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveTrackers( RedmineCb<Trackers> callback )
+{
+    ENTER();
+
+    coalesce<Trackers>( "trackers", callback, [=]( RedmineCb<Trackers> cb )
+    {
+        SimpleRedmineClient::retrieveTrackers( [=]( Trackers trackers, RedmineError redmineError,
+                                                    QStringList errors )
+        {
+            cb( trackers, redmineError, errors );
+        } );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::retrieveVersions( RedmineCb<Versions> callback, int projectId, const QString& parameters )
+{
+    ENTER()(projectId)(parameters);
+
+    QString key = QString("projects/%1/versions?%2").arg(projectId).arg(parameters);
+
+    coalesce<Versions>( key, callback, [=]( RedmineCb<Versions> cb )
+    {
+        SimpleRedmineClient::retrieveVersions( [=]( Versions versions, RedmineError redmineError,
+                                                    QStringList errors )
+        {
+            cb( versions, redmineError, errors );
+        },
+        projectId, parameters );
+    } );
+
+    RETURN();
+}
+
+void
+RedmineSession::setAuthenticator( QString apiKey )
+{
+    ENTER();
+
+    // Requests of another user must not be shared
+    if( apiKey != apiKey_ )
+        inFlight_.clear();
+
+    apiKey_ = apiKey;
+    SimpleRedmineClient::setAuthenticator( apiKey );
+
+    RETURN();
+}
+
+void
+RedmineSession::setUrl( QString url )
+{
+    ENTER()(url);
+
+    // Requests to another server must not be shared
+    if( url != url_ )
+        inFlight_.clear();
+
+    url_ = url;
+    SimpleRedmineClient::setUrl( url );
+
+    RETURN();
+}
+
+void
+RedmineSession::submit( const QString& resource, QNetworkAccessManager::Operation operation,
+                        const QJsonObject& data, SubmitCb callback )
+{
+    ENTER()(resource)(operation);
+
+    ++sent_;
+    DEBUG()(sent_)(coalesced_);
+
+    sendRequest( resource, [=]( QNetworkReply* reply, QJsonDocument* json )
+    {
+        ENTER();
+
+        // Zero if no HTTP response has been received
+        int status = reply->attribute( QNetworkRequest::HttpStatusCodeAttribute ).toInt();
+
+        if( reply->error() == QNetworkReply::NoError )
+        {
+            callback( true, status, RedmineError::NO_ERR, QStringList() );
+            RETURN();
+        }
+
+        QStringList errors;
+        if( json && json->isObject() )
+        {
+            for( const auto& error : json->object().value("errors").toArray() )
+                errors.append( error.toString() );
+        }
+
+        if( errors.isEmpty() )
+            errors.append( reply->errorString() );
+
+        DEBUG()(status)(errors);
+
+        callback( false, status, RedmineError::ERR_NOT_SAVED, errors );
+
+        RETURN();
+    },
+    operation, QString(), QJsonDocument(data).toJson(QJsonDocument::Compact) );
+
+    RETURN();
+}
+
+void
+RedmineSession::submitIssueStatus( int issueId, int statusId, SubmitCb callback )
+{
+    ENTER()(issueId)(statusId);
+
+    QJsonObject issue;
+    issue["status_id"] = statusId;
+
+    QJsonObject data;
+    data["issue"] = issue;
+
+    submit( QString("issues/%1").arg(issueId), QNetworkAccessManager::PutOperation, data, callback );
+
+    RETURN();
+}
+
+void
+RedmineSession::submitTimeEntry( const TimeEntry& timeEntry, SubmitCb callback )
+{
+    ENTER()(timeEntry.issue.id)(timeEntry.hours);
+
+    // Redmine does not accept time entries below 0.01 hours
+    if( timeEntry.hours < 0.01 )
+    {
+        callback( false, 0, RedmineError::ERR_TIME_ENTRY_TOO_SHORT, QStringList("Time entry too short") );
+        RETURN();
+    }
+
+    QJsonObject data;
+    data["time_entry"] = toJson( timeEntry );
+
+    submit( "time_entries", QNetworkAccessManager::PostOperation, data, callback );
+
+    RETURN();
+}
+
+void
+RedmineSession::streamIssues( std::function<void(const Issue&)> record, RedmineCb<int> callback,
+                              const QString& parameters )
+{
+    ENTER()(parameters);
+
+    streamRecords<Issue>( "issues", "issues", []( const QJsonObject& object )
+    {
+        Issue issue;
+        fromJson( object, issue );
+        return issue;
+    },
+    record, callback, parameters );
+
+    RETURN();
+}
+
+template<typename T>
+void
+RedmineSession::streamRecords( const QString& resource, const QString& listKey,
+                               std::function<T(const QJsonObject&)> decode, std::function<void(const T&)> record,
+                               RedmineCb<int> callback, const QString& parameters )
+{
+    ENTER()(resource)(listKey)(parameters);
+
+    auto stream = std::make_shared<Stream<T>>();
+    stream->decode = decode;
+    stream->record = record;
+    stream->callback = callback;
+    stream->context = this;
+
+    // The reader belongs to the stream, so refer to the stream without owning it
+    Stream<T>* owner = stream.get();
+    stream->reader.reset( new JsonListReader(listKey, [owner]( const QJsonObject& object )
+    {
+        owner->decoded.push_back( owner->decode(object) );
+    }) );
+
+    ++sent_;
+    DEBUG()(sent_)(coalesced_);
+
+    QNetworkReply* reply = sendRequest( resource, [=]( QNetworkReply* reply, QJsonDocument* )
+    {
+        ENTER();
+
+        // Hand over the remainder in case it has not been announced by readyRead()
+        stream->queued.append( reply->readAll() );
+
+        if( reply->error() != QNetworkReply::NoError )
+            stream->error = reply->errorString();
+
+        stream->finished = true;
+        stream->pump();
+
+        RETURN();
+    },
+    QNetworkAccessManager::GetOperation, parameters );
+
+    // Decode records while the response is still arriving
+    connect( reply, &QNetworkReply::readyRead, [=]()
+    {
+        stream->queued.append( reply->readAll() );
+        stream->pump();
+    } );
+
+    RETURN();
+}
+
+} // redtimer
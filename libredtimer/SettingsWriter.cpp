@@ -0,0 +1,127 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/SettingsWriter.h"
+
+#include <QtConcurrent>
+
+namespace redtimer {
+
+SettingsWriter::SettingsWriter( int profileId, QObject* parent )
+    : QObject( parent ),
+      profileId_( profileId )
+{
+    ENTER()(profileId);
+
+    ProfileStore::load( profileId_, &values_ );
+
+    timer_ = new QTimer( this );
+    timer_->setSingleShot( true );
+    connect( timer_, &QTimer::timeout, this, &SettingsWriter::flush );
+
+    watcher_ = new QFutureWatcher<bool>( this );
+    connect( watcher_, &QFutureWatcher<bool>::finished, [=]()
+    {
+        ENTER();
+
+        bool success = watcher_->result();
+        DEBUG()(success);
+
+        emit written( success );
+
+        // Keep the changes of a failed write and try again later
+        if( !success )
+        {
+            dirty_ = true;
+            timer_->start( RETRY_DELAY );
+            RETURN();
+        }
+
+        // Write the changes that have been queued in the meantime
+        if( dirty_ && !timer_->isActive() )
+            timer_->start( COALESCE_DELAY );
+
+        RETURN();
+    } );
+
+    RETURN();
+}
+
+SettingsWriter::~SettingsWriter()
+{
+    ENTER();
+    sync();
+    RETURN();
+}
+
+void
+SettingsWriter::flush()
+{
+    ENTER()(dirty_);
+
+    timer_->stop();
+
+    // Wait for the write in flight, the next write is started when it has finished
+    if( !dirty_ || watcher_->isRunning() )
+        RETURN();
+
+    dirty_ = false;
+
+    // The worker writes an implicitly shared copy of the values
+    watcher_->setFuture( QtConcurrent::run(&ProfileStore::save, profileId_, values_) );
+
+    RETURN();
+}
+
+bool
+SettingsWriter::isPending() const
+{
+    ENTER();
+    RETURN( dirty_ || watcher_->isRunning() );
+}
+
+void
+SettingsWriter::setValue( const QString& key, const QVariant& value )
+{
+    auto it = values_.constFind( key );
+    if( it != values_.constEnd() && it.value() == value )
+        return;
+
+    values_.insert( key, value );
+    dirty_ = true;
+
+    if( !timer_->isActive() )
+        timer_->start( COALESCE_DELAY );
+}
+
+bool
+SettingsWriter::sync()
+{
+    ENTER()(dirty_);
+
+    timer_->stop();
+
+    // Write the changes of a failed write in flight again, they are no longer marked as dirty
+    if( watcher_->isRunning() )
+    {
+        watcher_->waitForFinished();
+
+        if( !watcher_->result() )
+            dirty_ = true;
+    }
+
+    bool success = true;
+    if( dirty_ )
+    {
+        success = ProfileStore::save( profileId_, values_ );
+        dirty_ = !success;
+    }
+
+    RETURN( success );
+}
+
+QVariant
+SettingsWriter::value( const QString& key, const QVariant& defaultValue ) const
+{
+    return values_.value( key, defaultValue );
+}
+
+} // redtimer
@@ -0,0 +1,87 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/StringPool.h"
+
+#include <QMutexLocker>
+
+namespace redtimer {
+
+int
+StringPool::id( const QString& string )
+{
+    QMutexLocker locker( &mutex_ );
+    return lookup( string );
+}
+
+StringPool&
+StringPool::instance()
+{
+    static StringPool pool;
+    return pool;
+}
+
+QString
+StringPool::intern( const QString& string )
+{
+    // Null and empty strings do not own a buffer
+    if( string.isEmpty() )
+        return string;
+
+    QMutexLocker locker( &mutex_ );
+
+    const QString& interned = strings_.at( lookup(string) );
+
+    // Only a separate copy that is replaced by the interned string saves memory
+    if( interned.constData() != string.constData() )
+        bytesSaved_ += string.size() * sizeof(QChar);
+
+    return interned;
+}
+
+int
+StringPool::lookup( const QString& string )
+{
+    ++requests_;
+
+    auto it = ids_.constFind( string );
+    if( it != ids_.constEnd() )
+        return it.value();
+
+    int id = strings_.size();
+    strings_.push_back( string );
+    ids_.insert( string, id );
+
+    return id;
+}
+
+QString
+StringPool::report() const
+{
+    ENTER();
+
+    QMutexLocker locker( &mutex_ );
+
+    quint64 bytes = 0;
+    for( const auto& string : strings_ )
+        bytes += string.size() * sizeof(QChar);
+
+    QString report = QString("%1 interned strings with %2 KiB, %3 requests, %4 KiB saved")
+                     .arg(strings_.size())
+                     .arg(bytes / 1024)
+                     .arg(requests_)
+                     .arg(bytesSaved_ / 1024);
+
+    RETURN( report );
+}
+
+QString
+StringPool::string( int id ) const
+{
+    QMutexLocker locker( &mutex_ );
+
+    if( id < 0 || id >= strings_.size() )
+        return QString();
+
+    return strings_.at( id );
+}
+
+} // redtimer
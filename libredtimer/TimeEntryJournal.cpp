@@ -0,0 +1,652 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/Serialisation.h"
+#include "redtimer/TimeEntryJournal.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTimer>
+#include <QtGlobal>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+/// Magic number of the journal file
+#define JOURNAL_MAGIC 0x52544a4c // "RTJL"
+
+/// HTTP status code of entries that Redmine rejects as invalid
+#define HTTP_UNPROCESSABLE_ENTITY 422
+
+namespace {
+
+/// Record types
+enum RecordType : quint8
+{
+    RECORD_TIME_ENTRY   = 1,
+    RECORD_ISSUE_STATUS = 2,
+    RECORD_ACK          = 3
+};
+
+/**
+ * @brief Flush a file and synchronise it to disk
+ */
+bool
+sync( QFile& file )
+{
+    if( !file.flush() )
+        return false;
+
+#ifdef Q_OS_WIN
+    return _commit( file.handle() ) == 0;
+#else
+    return fsync( file.handle() ) == 0;
+#endif
+}
+
+/**
+ * @brief Frame a record payload with its length and checksum
+ */
+QByteArray
+frame( const QByteArray& payload )
+{
+    QByteArray record;
+    QDataStream stream( &record, QIODevice::WriteOnly );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    stream << (quint32)payload.size() << qChecksum( payload.constData(), payload.size() );
+    record.append( payload );
+
+    return record;
+}
+
+/**
+ * @brief Serialise a journal entry to a framed record
+ */
+QByteArray
+entryRecord( const TimeEntryJournal::Entry& entry )
+{
+    QByteArray payload;
+    QDataStream stream( &payload, QIODevice::WriteOnly );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    if( entry.type == TimeEntryJournal::Entry::Type::TimeEntry )
+        stream << (quint8)RECORD_TIME_ENTRY << entry.seq << entry.timeEntry;
+    else
+        stream << (quint8)RECORD_ISSUE_STATUS << entry.seq << entry.issueId << entry.statusId;
+
+    return frame( payload );
+}
+
+/**
+ * @brief Serialise a journal file header
+ */
+QByteArray
+header( const QString& url )
+{
+    QByteArray data;
+    QDataStream stream( &data, QIODevice::WriteOnly );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    writeHeader( stream, JOURNAL_MAGIC, TimeEntryJournal::VERSION, url );
+
+    return data;
+}
+
+} // anonymous
+
+const int TimeEntryJournal::MIN_BACKOFF;
+const int TimeEntryJournal::MAX_BACKOFF;
+
+TimeEntryJournal::TimeEntryJournal( RedmineSession* redmine, QObject* parent )
+    : QObject( parent ),
+      redmine_( redmine )
+{
+    retryTimer_ = new QTimer( this );
+    retryTimer_->setSingleShot( true );
+    connect( retryTimer_, &QTimer::timeout, this, &TimeEntryJournal::retry );
+}
+
+void
+TimeEntryJournal::acknowledge( const QString& fileName, quint64 seq )
+{
+    ENTER()(fileName)(seq);
+
+    bool current = fileName == fileName_;
+
+    if( current )
+    {
+        for( auto it = pending_.begin(); it != pending_.end(); ++it )
+        {
+            if( it->seq == seq )
+            {
+                pending_.erase( it );
+                break;
+            }
+        }
+    }
+
+    // Start over with an empty file once everything has been acknowledged
+    if( current && pending_.isEmpty() )
+    {
+        emit drained();
+
+        QFile file( fileName );
+        if( file.open(QIODevice::ReadWrite) && file.resize(0) && file.write(header(url_)) != -1 && sync(file) )
+            RETURN();
+    }
+
+    QByteArray payload;
+    QDataStream stream( &payload, QIODevice::WriteOnly );
+    stream.setVersion( QDataStream::Qt_5_5 );
+    stream << (quint8)RECORD_ACK << seq;
+
+    if( !write(fileName, frame(payload)) )
+        DEBUG() << "Could not write acknowledgement, the entry might be sent again";
+
+    RETURN();
+}
+
+bool
+TimeEntryJournal::append( Entry entry )
+{
+    ENTER()(fileName_);
+
+    if( fileName_.isEmpty() )
+        RETURN( false );
+
+    entry.seq = nextSeq_;
+
+    if( !write(fileName_, entryRecord(entry)) )
+        RETURN( false );
+
+    ++nextSeq_;
+    pending_.append( entry );
+
+    DEBUG()(entry.seq)(pending_.size());
+
+    RETURN( true );
+}
+
+bool
+TimeEntryJournal::appendIssueStatus( int issueId, int statusId )
+{
+    ENTER()(issueId)(statusId);
+
+    Entry entry;
+    entry.type = Entry::Type::IssueStatus;
+    entry.issueId = issueId;
+    entry.statusId = statusId;
+
+    RETURN( append(entry) );
+}
+
+bool
+TimeEntryJournal::appendTimeEntry( const TimeEntry& timeEntry )
+{
+    ENTER()(timeEntry.issue.id)(timeEntry.hours);
+
+    Entry entry;
+    entry.type = Entry::Type::TimeEntry;
+    entry.timeEntry = timeEntry;
+
+    RETURN( append(entry) );
+}
+
+bool
+TimeEntryJournal::isEmpty() const
+{
+    ENTER();
+    RETURN( pending_.isEmpty() );
+}
+
+bool
+TimeEntryJournal::load()
+{
+    ENTER()(fileName_);
+
+    pending_.clear();
+    nextSeq_ = 1;
+
+    QFile file( fileName_ );
+    if( !file.exists() || !file.open(QIODevice::ReadWrite) )
+        RETURN( false );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    if( !readHeader(stream, JOURNAL_MAGIC, VERSION, url_) )
+    {
+        // Never discard a journal that might still contain time entries, and never send them elsewhere
+        if( file.size() != 0 )
+        {
+            QString backup = QString("%1.%2").arg(fileName_).arg(QDateTime::currentMSecsSinceEpoch());
+            DEBUG() << "Unknown journal format or Redmine URL, moving it to" << backup;
+            file.close();
+            QFile::rename( fileName_, backup );
+        }
+
+        RETURN( false );
+    }
+
+    qint64 validSize = file.pos();
+    bool corrupt = false;
+
+    while( !file.atEnd() )
+    {
+        quint32 length;
+        quint16 checksum;
+        stream >> length >> checksum;
+
+        // A record cut off by the end of the file is a torn write
+        if( stream.status() != QDataStream::Ok )
+            break;
+
+        QByteArray payload = file.read( length );
+        if( (quint32)payload.size() != length )
+            break;
+
+        validSize = file.pos();
+
+        // A complete record that does not match its checksum is skipped using its length
+        if( qChecksum(payload.constData(), payload.size()) != checksum )
+        {
+            DEBUG() << "Skipping corrupt journal record";
+            corrupt = true;
+            continue;
+        }
+
+        QDataStream record( payload );
+        record.setVersion( QDataStream::Qt_5_5 );
+
+        quint8 type;
+        quint64 seq;
+        record >> type >> seq;
+
+        if( record.status() != QDataStream::Ok )
+        {
+            corrupt = true;
+            continue;
+        }
+
+        if( type == RECORD_ACK )
+        {
+            for( auto it = pending_.begin(); it != pending_.end(); ++it )
+            {
+                if( it->seq == seq )
+                {
+                    pending_.erase( it );
+                    break;
+                }
+            }
+        }
+        else
+        {
+            Entry entry;
+            entry.seq = seq;
+
+            if( type == RECORD_TIME_ENTRY )
+            {
+                entry.type = Entry::Type::TimeEntry;
+                record >> entry.timeEntry;
+            }
+            else
+            {
+                entry.type = Entry::Type::IssueStatus;
+                record >> entry.issueId >> entry.statusId;
+            }
+
+            if( record.status() != QDataStream::Ok )
+            {
+                corrupt = true;
+                continue;
+            }
+
+            pending_.append( entry );
+        }
+
+        nextSeq_ = qMax( nextSeq_, seq + 1 );
+    }
+
+    if( corrupt )
+    {
+        // Keep a copy of the corrupt journal, then rewrite it from the entries that could be read
+        QString backup = QString("%1.%2.corrupt").arg(fileName_).arg(QDateTime::currentMSecsSinceEpoch());
+        DEBUG() << "Corrupt journal, copying it to" << backup;
+        file.close();
+
+        if( QFile::copy(fileName_, backup) && rewrite() )
+        {
+            DEBUG()(pending_.size())(nextSeq_);
+            RETURN( true );
+        }
+
+        if( !file.open(QIODevice::ReadWrite) )
+            RETURN( true );
+    }
+
+    // Discard a torn write at the end of the file so that new records can be appended
+    if( file.size() != validSize )
+    {
+        DEBUG() << "Discarding incomplete journal record";
+        file.resize( validSize );
+        sync( file );
+    }
+
+    DEBUG()(pending_.size())(nextSeq_);
+
+    RETURN( true );
+}
+
+void
+TimeEntryJournal::open( int profileId, const QString& url )
+{
+    ENTER()(profileId)(url);
+
+    // Every Redmine URL has its own journal so that entries are only ever sent to the server they belong to
+    QByteArray urlHash = QCryptographicHash::hash( url.toUtf8(), QCryptographicHash::Sha1 ).toHex().left( 16 );
+
+    QDir dir( QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) );
+    QString fileName = dir.filePath( QString("profile-%1/journal-%2.log").arg(profileId)
+                                     .arg(QString::fromLatin1(urlHash)) );
+
+    if( fileName == fileName_ )
+        RETURN();
+
+    fileName_ = fileName;
+    url_ = url;
+
+    // Requests of the previous journal acknowledge themselves in their own file
+    inFlight_.clear();
+    reported_.clear();
+    retryTimer_->stop();
+    failed_ = false;
+    backoff_ = 0;
+
+    load();
+
+    RETURN();
+}
+
+void
+TimeEntryJournal::replay()
+{
+    ENTER()(pending_.size())(inFlight_.size())(failed_);
+
+    // While failed requests are still in flight, the retry is scheduled once they have finished
+    if( failed_ && !inFlight_.isEmpty() )
+        RETURN();
+
+    retryTimer_->stop();
+    failed_ = false;
+
+    dispatch();
+
+    RETURN();
+}
+
+void
+TimeEntryJournal::dispatch()
+{
+    ENTER()(pending_.size())(inFlight_.size());
+
+    if( failed_ )
+        RETURN();
+
+    for( const auto& entry : pending_ )
+    {
+        if( inFlight_.size() >= maxParallel_ )
+            break;
+
+        // Issue status updates are barriers: they are sent on their own and in order
+        if( inFlight_.contains(entry.seq) )
+        {
+            if( entry.type == Entry::Type::IssueStatus )
+                break;
+
+            continue;
+        }
+
+        if( entry.type == Entry::Type::IssueStatus && !inFlight_.isEmpty() )
+            break;
+
+        send( entry );
+
+        if( entry.type == Entry::Type::IssueStatus )
+            break;
+    }
+
+    RETURN();
+}
+
+void
+TimeEntryJournal::retry()
+{
+    ENTER()(backoff_);
+
+    failed_ = false;
+    dispatch();
+
+    RETURN();
+}
+
+bool
+TimeEntryJournal::reject( const QString& fileName, const QString& url, const Entry& entry ) const
+{
+    ENTER()(fileName)(entry.seq);
+
+    // Rejected entries are kept in the journal format so that they can be inspected or sent again
+    QFile file( fileName + ".rejected" );
+    if( !file.open(QIODevice::WriteOnly | QIODevice::Append) )
+        RETURN( false );
+
+    if( file.size() == 0 && file.write(header(url)) == -1 )
+        RETURN( false );
+
+    QByteArray record = entryRecord( entry );
+    if( file.write(record) != record.size() )
+        RETURN( false );
+
+    RETURN( sync(file) );
+}
+
+bool
+TimeEntryJournal::rewrite() const
+{
+    ENTER()(fileName_)(pending_.size());
+
+    QSaveFile file( fileName_ );
+    if( !file.open(QIODevice::WriteOnly) )
+        RETURN( false );
+
+    file.write( header(url_) );
+
+    for( const auto& entry : pending_ )
+        file.write( entryRecord(entry) );
+
+    RETURN( file.commit() );
+}
+
+void
+TimeEntryJournal::send( const Entry& entry )
+{
+    ENTER()(entry.seq);
+
+    inFlight_.insert( entry.seq );
+
+    QString fileName = fileName_;
+    QString url = url_;
+
+    // The result might be reported synchronously, e.g. for a too short time entry. Handle it from the event
+    // loop so that pending_ is never changed and dispatch() never reentered while dispatch() is sending.
+    auto cb = [=]( bool success, int status, RedmineError errorCode, QStringList errors )
+    {
+        ENTER()(success)(status)(errorCode)(errors);
+
+        QTimer::singleShot( 0, this, [=]()
+        {
+            sent( fileName, url, entry, success, status, errorCode, errors );
+        } );
+
+        RETURN();
+    };
+
+    if( entry.type == Entry::Type::TimeEntry )
+        redmine_->submitTimeEntry( entry.timeEntry, cb );
+    else
+        redmine_->submitIssueStatus( entry.issueId, entry.statusId, cb );
+
+    RETURN();
+}
+
+void
+TimeEntryJournal::sent( const QString& fileName, const QString& url, const Entry& entry, bool success, int status,
+                        RedmineError errorCode, const QStringList& errors )
+{
+    ENTER()(fileName)(entry.seq)(success)(status)(errorCode);
+
+    Outcome outcome = Outcome::Failed;
+
+    // Too short time entries will never be accepted
+    if( success
+        || (entry.type == Entry::Type::TimeEntry && errorCode == RedmineError::ERR_TIME_ENTRY_TOO_SHORT) )
+        outcome = Outcome::Done;
+
+    // Redmine reports invalid entries, e.g. for a closed issue or a status transition that is not allowed,
+    // as unprocessable. Sending them again is futile. Any other error, e.g. a server or proxy error or a
+    // timeout, might be temporary.
+    else if( status == HTTP_UNPROCESSABLE_ENTITY )
+        outcome = Outcome::Rejected;
+
+    settle( fileName, url, entry, outcome, success, errorCode, errors );
+
+    RETURN();
+}
+
+void
+TimeEntryJournal::settle( const QString& fileName, const QString& url, const Entry& entry, Outcome outcome,
+                          bool success, RedmineError errorCode, const QStringList& errors )
+{
+    ENTER()(fileName)(entry.seq)((int)outcome);
+
+    // Rejected entries are only removed from the journal once they have been kept elsewhere
+    if( outcome == Outcome::Rejected && !reject(fileName, url, entry) )
+    {
+        DEBUG() << "Could not write the rejected entry, keeping it in the journal";
+        outcome = Outcome::Failed;
+    }
+
+    bool done = outcome != Outcome::Failed;
+
+    // The journal might have been switched to another profile in the meantime
+    bool current = fileName == fileName_;
+    if( current )
+        inFlight_.remove( entry.seq );
+
+    if( done )
+        acknowledge( fileName, entry.seq );
+
+    // Report rejected entries once and failed entries only upon their first failure
+    bool report = outcome == Outcome::Done || !reported_.contains( entry.seq );
+
+    if( current && outcome == Outcome::Failed )
+        reported_.insert( entry.seq );
+    else
+        reported_.remove( entry.seq );
+
+    if( outcome == Outcome::Rejected )
+    {
+        DEBUG() << "Redmine rejected the entry, moving it to the rejected entries";
+
+        if( entry.type == Entry::Type::TimeEntry )
+            emit timeEntryRejected( entry.timeEntry, errors );
+        else
+            emit issueStatusRejected( entry.issueId, entry.statusId, errors );
+    }
+    else if( report )
+    {
+        if( entry.type == Entry::Type::TimeEntry )
+            emit timeEntrySent( entry.timeEntry, success, errorCode, errors );
+        else
+            emit issueStatusSent( entry.issueId, entry.statusId, success, errorCode, errors );
+    }
+
+    if( !current )
+        RETURN();
+
+    if( !done )
+        failed_ = true;
+    else if( !failed_ )
+        backoff_ = 0;
+
+    if( !failed_ )
+    {
+        dispatch();
+        RETURN();
+    }
+
+    // Retry with exponential backoff once all requests of this round have finished
+    if( inFlight_.isEmpty() )
+    {
+        backoff_ = backoff_ == 0 ? MIN_BACKOFF : qMin( backoff_ * 2, MAX_BACKOFF );
+        DEBUG() << "Retrying in" << backoff_ << "ms";
+        retryTimer_->start( backoff_ );
+    }
+
+    RETURN();
+}
+
+void
+TimeEntryJournal::setMaxParallel( int maxParallel )
+{
+    ENTER()(maxParallel);
+    maxParallel_ = qMax( 1, maxParallel );
+    RETURN();
+}
+
+int
+TimeEntryJournal::size() const
+{
+    ENTER();
+    RETURN( pending_.size() );
+}
+
+bool
+TimeEntryJournal::write( const QString& fileName, const QByteArray& record ) const
+{
+    ENTER()(fileName)(record.size());
+
+    QDir().mkpath( QFileInfo(fileName).absolutePath() );
+
+    QFile file( fileName );
+    if( !file.open(QIODevice::WriteOnly | QIODevice::Append) )
+        RETURN( false );
+
+    if( file.size() == 0 )
+    {
+        // An empty journal of another URL has nothing left to acknowledge
+        if( fileName != fileName_ )
+            RETURN( true );
+
+        if( file.write(header(url_)) == -1 )
+            RETURN( false );
+    }
+
+    if( file.write(record) != record.size() )
+        RETURN( false );
+
+    RETURN( sync(file) );
+}
+
+} // redtimer
@@ -0,0 +1,148 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/TimerEngine.h"
+
+#include <QElapsedTimer>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_MAC)
+#include <time.h>
+#endif
+
+namespace redtimer {
+
+const qint64 TimerEngine::SUSPEND_THRESHOLD;
+
+TimerEngine::TimerEngine( Clock monotonic, Clock boot )
+    : monotonic_( monotonic ),
+      boot_( boot )
+{}
+
+qint64
+TimerEngine::bootClock()
+{
+#if defined(Q_OS_LINUX) && defined(CLOCK_BOOTTIME)
+    timespec time;
+    if( clock_gettime(CLOCK_BOOTTIME, &time) == 0 )
+        return static_cast<qint64>( time.tv_sec ) * 1000 + time.tv_nsec / 1000000;
+#elif defined(Q_OS_MAC)
+    // Unlike the monotonic clock of QElapsedTimer, CLOCK_MONOTONIC keeps running during sleep on macOS
+    return static_cast<qint64>( clock_gettime_nsec_np(CLOCK_MONOTONIC) / 1000000 );
+#endif
+
+    // Without a clock that counts suspended time, no suspend can be confirmed
+    return monotonicClock();
+}
+
+qint64
+TimerEngine::elapsed() const
+{
+    qint64 elapsed = accumulated_ + adjustment_;
+
+    if( running_ )
+        elapsed += monotonic_() - segmentStart_;
+
+    return elapsed;
+}
+
+bool
+TimerEngine::isRunning() const
+{
+    return running_;
+}
+
+qint64
+TimerEngine::monotonicClock()
+{
+    static QElapsedTimer clock = []()
+    {
+        QElapsedTimer clock;
+        clock.start();
+        return clock;
+    }();
+
+    return clock.elapsed();
+}
+
+void
+TimerEngine::reset()
+{
+    ENTER()(running_);
+
+    accumulated_ = 0;
+    adjustment_ = 0;
+    suspended_ = 0;
+
+    if( running_ )
+    {
+        segmentStart_ = monotonic_();
+        segmentBootStart_ = boot_();
+    }
+
+    RETURN();
+}
+
+int
+TimerEngine::seconds() const
+{
+    return static_cast<int>( elapsed() / 1000 );
+}
+
+qint64
+TimerEngine::segmentGap() const
+{
+    if( !running_ )
+        return 0;
+
+    qint64 gap = (boot_() - segmentBootStart_) - (monotonic_() - segmentStart_);
+
+    return gap >= SUSPEND_THRESHOLD ? gap : 0;
+}
+
+void
+TimerEngine::setElapsed( qint64 msecs )
+{
+    ENTER()(msecs);
+
+    adjustment_ += msecs - elapsed();
+
+    RETURN();
+}
+
+void
+TimerEngine::start()
+{
+    ENTER()(running_);
+
+    if( running_ )
+        RETURN();
+
+    segmentStart_ = monotonic_();
+    segmentBootStart_ = boot_();
+    running_ = true;
+
+    RETURN();
+}
+
+void
+TimerEngine::stop()
+{
+    ENTER()(running_);
+
+    if( !running_ )
+        RETURN();
+
+    suspended_ += segmentGap();
+    accumulated_ += monotonic_() - segmentStart_;
+    running_ = false;
+
+    DEBUG()(accumulated_)(suspended_);
+
+    RETURN();
+}
+
+qint64
+TimerEngine::suspended() const
+{
+    return suspended_ + segmentGap();
+}
+
+} // redtimer
@@ -0,0 +1,125 @@
+#include "qtredmine/Logging.h"
+#include "redtimer/Serialisation.h"
+#include "redtimer/UiSnapshot.h"
+
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+using namespace qtredmine;
+
+namespace redtimer {
+
+/// Magic number of the snapshot file
+#define UI_SNAPSHOT_MAGIC 0x52545553 // "RTUS"
+
+void
+UiSnapshot::clear()
+{
+    ENTER();
+
+    issue = Issue();
+    issue.id = NULL_ID;
+    activities.clear();
+    activityIndex = 0;
+    issueStatuses.clear();
+    issueStatusIndex = 0;
+
+    RETURN();
+}
+
+bool
+UiSnapshot::isEmpty() const
+{
+    ENTER();
+    RETURN( issue.id == NULL_ID && activities.isEmpty() && issueStatuses.isEmpty() );
+}
+
+bool
+UiSnapshot::load()
+{
+    ENTER()(fileName_);
+
+    clear();
+
+    QFile file( fileName_ );
+    if( !file.open(QIODevice::ReadOnly) )
+        RETURN( false );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    if( !readHeader(stream, UI_SNAPSHOT_MAGIC, VERSION, url_) )
+    {
+        DEBUG() << "Discarding outdated UI snapshot";
+        RETURN( false );
+    }
+
+    qint32 activityIndex, issueStatusIndex;
+    stream >> issue
+           >> activities >> activityIndex
+           >> issueStatuses >> issueStatusIndex;
+
+    if( stream.status() != QDataStream::Ok )
+    {
+        DEBUG() << "UI snapshot is corrupt";
+        clear();
+        RETURN( false );
+    }
+
+    this->activityIndex = activityIndex;
+    this->issueStatusIndex = issueStatusIndex;
+
+    DEBUG()(issue.id)(activities.size())(issueStatuses.size());
+
+    RETURN( true );
+}
+
+void
+UiSnapshot::open( int profileId, const QString& url )
+{
+    ENTER()(profileId)(url);
+
+    QDir dir( QStandardPaths::writableLocation(QStandardPaths::CacheLocation) );
+    QString fileName = dir.filePath( QString("profile-%1/ui.snapshot").arg(profileId) );
+
+    if( fileName == fileName_ && url == url_ )
+        RETURN();
+
+    fileName_ = fileName;
+    url_ = url;
+
+    load();
+
+    RETURN();
+}
+
+bool
+UiSnapshot::save()
+{
+    ENTER()(fileName_);
+
+    if( fileName_.isEmpty() )
+        RETURN( false );
+
+    QDir().mkpath( QFileInfo(fileName_).absolutePath() );
+
+    QSaveFile file( fileName_ );
+    if( !file.open(QIODevice::WriteOnly) )
+        RETURN( false );
+
+    QDataStream stream( &file );
+    stream.setVersion( QDataStream::Qt_5_5 );
+
+    writeHeader( stream, UI_SNAPSHOT_MAGIC, VERSION, url_ );
+    stream << issue
+           << activities << (qint32)activityIndex
+           << issueStatuses << (qint32)issueStatusIndex;
+
+    RETURN( file.commit() );
+}
+
+} // redtimer
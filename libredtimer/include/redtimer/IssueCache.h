@@ -0,0 +1,142 @@
+#pragma once
+
+#include "qtredmine/SimpleRedmineTypes.h"
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+namespace redtimer {
+
+/**
+ * @brief Persistent cache of recently loaded Redmine issues
+ *
+ * Issues are keyed by their ID and tagged with their \c updated_on time stamp. The cache is stored per
+ * profile in the user's cache directory and is bound to a Redmine URL, i.e. it is discarded whenever the
+ * profile points to another Redmine instance.
+ */
+class IssueCache
+{
+private:
+    /// Cached issues
+    QHash<int, qtredmine::Issue> issues_;
+
+    /// Issue IDs, most recently used first
+    QList<int> order_;
+
+    /// Cache file name
+    QString fileName_;
+
+    /// Redmine URL the cached issues belong to
+    QString url_;
+
+    /// Maximum number of cached issues
+    int maxIssues_;
+
+private:
+    /**
+     * @brief Load the cache from the cache file
+     *
+     * @return true if the cache could be loaded, false otherwise
+     */
+    bool load();
+
+    /**
+     * @brief Mark an issue as most recently used
+     *
+     * @param issueId Issue ID
+     */
+    void touch( int issueId );
+
+public:
+    /// Version of the cache file format
+    static const quint32 VERSION = 1;
+
+    /**
+     * @brief Constructor for an IssueCache object
+     *
+     * @param maxIssues Maximum number of cached issues
+     */
+    explicit IssueCache( int maxIssues = 200 );
+
+    /// @name Getters
+    /// @{
+
+    /**
+     * @brief Determines whether an issue is cached
+     *
+     * @param issueId Issue ID
+     *
+     * @return true if the issue is cached, false otherwise
+     */
+    bool contains( int issueId ) const;
+
+    /**
+     * @brief Get a cached issue
+     *
+     * @param issueId Issue ID
+     *
+     * @return Cached issue or an empty issue if not cached
+     */
+    qtredmine::Issue issue( int issueId );
+
+    /// @}
+
+    /// @name Operations
+    /// @{
+
+    /**
+     * @brief Clear the cache and remove the cache file
+     */
+    void clear();
+
+    /**
+     * @brief Insert or update an issue
+     *
+     * The cache file will only be written if the issue has not been cached before or if its \c updated_on
+     * time stamp has changed.
+     *
+     * @param issue Issue to insert
+     *
+     * @return true if the issue was new or has changed, false otherwise
+     */
+    bool insert( const qtredmine::Issue& issue );
+
+    /**
+     * @brief Insert or update an issue that has been changed locally
+     *
+     * The issue is stored without its \c updated_on time stamp, so that it is replaced by the next issue
+     * inserted, e.g. when Redmine has rejected the change.
+     *
+     * @param issue Issue to insert
+     */
+    void insertUnconfirmed( qtredmine::Issue issue );
+
+    /**
+     * @brief Open the cache for a profile
+     *
+     * Does nothing if the cache is already open for the specified profile and URL.
+     *
+     * @param profileId Profile ID
+     * @param url Redmine URL of the profile
+     */
+    void open( int profileId, const QString& url );
+
+    /**
+     * @brief Remove an issue from the cache
+     *
+     * @param issueId Issue ID
+     */
+    void remove( int issueId );
+
+    /**
+     * @brief Save the cache to the cache file
+     *
+     * @return true if the cache could be saved, false otherwise
+     */
+    bool save();
+
+    /// @}
+};
+
+} // redtimer
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "qtredmine/SimpleRedmineTypes.h"
+
+#include <QDate>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+
+namespace redtimer {
+
+/**
+ * @brief Issue filters that are evaluated by Redmine
+ *
+ * The filters are translated into issue list parameters so that only matching issues are transferred.
+ * Unset filters are omitted; Redmine then applies its defaults, e.g. only open issues are listed.
+ */
+class IssueFilter
+{
+public:
+    /// @name Issue status filters
+    /// @{
+    static const int OPEN_STATUSES = -2;
+    static const int CLOSED_STATUSES = -3;
+    static const int ALL_STATUSES = -4;
+    /// @}
+
+    /// Issue status ID or one of the issue status filters, NULL_ID for open issues
+    int statusId = NULL_ID;
+
+    /// Tracker ID
+    int trackerId = NULL_ID;
+
+    /// Saved query ID
+    int queryId = NULL_ID;
+
+    /// Only issues updated on or after this date
+    QDate updatedFrom;
+
+    /// Only issues updated on or before this date
+    QDate updatedTo;
+
+    /// Text that the subject has to contain
+    QString subject;
+
+    /// Values of custom fields by custom field ID
+    QMap<int, QString> customFields;
+
+    /**
+     * @brief Check whether no filter has been set
+     *
+     * @return true if no filter has been set, false otherwise
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Create the issue list parameters
+     *
+     * @return Parameters joined by ampersands, values are percent-encoded
+     */
+    QString parameters() const;
+
+    /**
+     * @brief Set the text filters from a search text
+     *
+     * Terms of the form cf_<id>:<value> set a custom field filter, all other terms form the subject filter.
+     *
+     * @param text Search text
+     */
+    void setSearchText( const QString& text );
+
+    /**
+     * @brief Remove the terms that are only evaluated by Redmine from a search text
+     *
+     * @param text Search text
+     *
+     * @return Search text without custom field terms
+     */
+    static QString localSearchText( const QString& text );
+};
+
+} // redtimer
@@ -0,0 +1,143 @@
+#pragma once
+
+#include "qtredmine/SimpleRedmineTypes.h"
+#include "redtimer/IssueStore.h"
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace redtimer {
+
+/**
+ * @brief Inverted full-text index of issues
+ *
+ * Maps the tokens of the issue ID, subject, description and custom field values to the IDs of the issues
+ * that contain them. Tokens are kept in sorted order so that every query term is matched as a prefix.
+ * Issues can be added and removed one by one, i.e. the index is kept up to date alongside an issue list.
+ *
+ * Search results are ranked by the sum of the weights of the matched fields, exact token matches counting
+ * twice as much as prefix matches.
+ *
+ * Indexing and searching may run in worker threads and therefore do not log.
+ */
+class IssueIndex
+{
+private:
+    /// Weight of each issue by token
+    QMap<QString, QHash<int, int>> postings_;
+
+    /// Indexed tokens by issue ID
+    QHash<int, QStringList> tokens_;
+
+private:
+    /**
+     * @brief Add an issue to the index by its searchable fields
+     *
+     * @param issueId Issue ID
+     * @param subject Subject
+     * @param customFields Custom fields
+     * @param description Description
+     */
+    void add( int issueId, const QString& subject, const qtredmine::CustomFields& customFields,
+              const QString& description );
+
+public:
+    /// @name Field weights
+    /// @{
+    static const int ID_WEIGHT = 8;
+    static const int SUBJECT_WEIGHT = 4;
+    static const int CUSTOM_FIELD_WEIGHT = 2;
+    static const int DESCRIPTION_WEIGHT = 1;
+    /// @}
+
+    /**
+     * @brief Add an issue to the index
+     *
+     * Replaces a previously indexed issue with the same ID.
+     *
+     * @param issue Issue to add
+     */
+    void add( const qtredmine::Issue& issue );
+
+    /**
+     * @brief Add issues to the index
+     *
+     * @param issues Issues to add
+     */
+    void add( const qtredmine::Issues& issues );
+
+    /**
+     * @brief Add issues encoded for an issue store to the index
+     *
+     * @param block Encoded issues to add
+     */
+    void add( const IssueStore::Block& block );
+
+    /**
+     * @brief Remove all issues from the index
+     */
+    void clear();
+
+    /**
+     * @brief Check whether an issue has been indexed
+     *
+     * @param issueId Issue ID
+     *
+     * @return true if the issue has been indexed, false otherwise
+     */
+    bool contains( int issueId ) const;
+
+    /**
+     * @brief Merge another index into this index
+     *
+     * Issues of the other index replace previously indexed issues with the same ID. The cost only depends
+     * on the size of the other index.
+     *
+     * @param other Index to merge
+     */
+    void merge( const IssueIndex& other );
+
+    /**
+     * @brief Remove an issue from the index
+     *
+     * @param issueId Issue ID
+     */
+    void remove( int issueId );
+
+    /**
+     * @brief Search for issues
+     *
+     * An issue matches if each term of the query is a prefix of one of its tokens.
+     *
+     * @param query Search query
+     * @param candidates If specified, only these issues are considered, e.g. the matches of a previous
+     *                   query that the current query extends
+     *
+     * @return IDs of the matching issues, best match first
+     */
+    QVector<int> search( const QString& query, const QSet<int>* candidates = nullptr ) const;
+
+    /**
+     * @brief Get the number of indexed issues
+     *
+     * @return Number of indexed issues
+     */
+    int size() const;
+
+    /**
+     * @brief Split a text into lower case tokens
+     *
+     * Tokens consist of letters and digits; all other characters separate tokens.
+     *
+     * @param text Text to split
+     *
+     * @return List of tokens
+     */
+    static QStringList tokenise( const QString& text );
+};
+
+} // redtimer
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "redtimer/IssueStore.h"
+#include "redtimer/RedmineSession.h"
+
+#include <QMap>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+namespace redtimer {
+
+/**
+ * @brief Loads an issue list page by page
+ *
+ * Instead of waiting for all pages of an issue list, every page is handed out as soon as it has arrived,
+ * so that the first page can be displayed after a single round trip. Issues that appear on more than one
+ * page, e.g. because the list changed on the server while loading, are only handed out once.
+ *
+ * The number of issues is requested alongside the first page. Once it is known, the remaining pages are
+ * requested in parallel up to a limit and handed out in list order. If the number cannot be determined,
+ * the pages are requested one after another until a page is not full.
+ *
+ * Each page is read record by record while it arrives, so no page is held as a whole JSON document. Pages
+ * are encoded for an IssueStore in a worker thread and only handed out in encoded form.
+ *
+ * Starting a new load or cancelling discards all pages of a previous load that arrive afterwards.
+ */
+class IssueListLoader : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Redmine session
+    RedmineSession* redmine_;
+
+    /// Parameters of the current load
+    QString parameters_;
+
+    /// Number of issues per page
+    int pageSize_ = 100;
+
+    /// Offset of the next page to request
+    int offset_ = 0;
+
+    /// Offset of the next page to hand out
+    int emitOffset_ = 0;
+
+    /// Number of issues in the list, NULL_ID if unknown
+    int total_ = NULL_ID;
+
+    /// Offset at which the list ends as seen from a page that was not full, NULL_ID if unknown
+    int end_ = NULL_ID;
+
+    /// Maximum number of parallel page requests
+    int maxParallel_ = 4;
+
+    /// Number of page requests in flight
+    int inFlight_ = 0;
+
+    /// Encoded pages that have arrived ahead of the next page to hand out by offset
+    QMap<int, IssueStore::Block> pages_;
+
+    /// Load generation, increased upon each start and cancel
+    quint64 generation_ = 0;
+
+    /// Currently loading
+    bool loading_ = false;
+
+    /// IDs of the issues handed out by the current load
+    QSet<int> issueIds_;
+
+private:
+    /**
+     * @brief Request pages up to the parallel request limit
+     */
+    void dispatch();
+
+    /**
+     * @brief Hand out the pages that have arrived in list order
+     */
+    void flush();
+
+    /**
+     * @brief Retrieve a page
+     *
+     * @param offset Offset of the page
+     */
+    void retrievePage( int offset );
+
+public:
+    /**
+     * @brief Constructor for an IssueListLoader object
+     *
+     * @param redmine Redmine session
+     * @param parent Parent QObject
+     */
+    explicit IssueListLoader( RedmineSession* redmine, QObject* parent = nullptr );
+
+    /**
+     * @brief Cancel the current load
+     */
+    void cancel();
+
+    /**
+     * @brief Get the number of issues loaded so far
+     *
+     * @return Number of loaded issues
+     */
+    int loaded() const;
+
+    /**
+     * @brief Check whether a load is in progress
+     *
+     * @return true if loading, false otherwise
+     */
+    bool loading() const;
+
+    /**
+     * @brief Set the maximum number of parallel page requests
+     *
+     * @param maxParallel Maximum number of parallel page requests
+     */
+    void setMaxParallel( int maxParallel );
+
+    /**
+     * @brief Set the number of issues per page
+     *
+     * @param pageSize Number of issues per page, Redmine allows at most 100
+     */
+    void setPageSize( int pageSize );
+
+    /**
+     * @brief Start loading issues
+     *
+     * Cancels the current load, if any.
+     *
+     * @param parameters Issue filter parameters
+     */
+    void start( const QString& parameters );
+
+signals:
+    /**
+     * @brief Emitted when loading has failed
+     *
+     * @param errors Error messages
+     */
+    void failed( QStringList errors );
+
+    /**
+     * @brief Emitted when all pages have been loaded
+     *
+     * @param loaded Number of loaded issues
+     */
+    void finished( int loaded );
+
+    /**
+     * @brief Emitted when a page has been loaded
+     *
+     * @param block Issues of the page that have not been handed out before, encoded for an issue store
+     * @param first This is the first page of the load
+     * @param loaded Number of issues loaded so far
+     */
+    void pageLoaded( IssueStore::Block block, bool first, int loaded );
+};
+
+} // redtimer
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "qtredmine/SimpleRedmineTypes.h"
+
+#include <QHash>
+#include <QObject>
+#include <QSharedPointer>
+#include <QWeakPointer>
+
+namespace redtimer {
+
+/// Shared read-only reference to an issue
+using IssueHandle = QSharedPointer<const qtredmine::Issue>;
+
+/**
+ * @brief Canonical store of the issues that are in use, keyed by issue ID
+ *
+ * Windows hold IssueHandle references instead of their own copies of an issue. Issues are immutable; an
+ * update replaces the issue in the registry and emits changed(), upon which views fetch the new handle.
+ * Holders of a previous handle keep a consistent snapshot until then.
+ *
+ * The registry only keeps issues alive as long as a handle refers to them.
+ *
+ * Issue lists do not hold handles: their models keep compact rows in an IssueStore and update these rows
+ * from changed(). The settings only keep the IDs and subjects of the recent issues.
+ */
+class IssueRegistry : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Registered issues by issue ID
+    QHash<int, QWeakPointer<const qtredmine::Issue>> issues_;
+
+public:
+    /**
+     * @brief Constructor for an IssueRegistry object
+     *
+     * @param parent Parent QObject
+     */
+    explicit IssueRegistry( QObject* parent = nullptr );
+
+    /**
+     * @brief Get the handle of an issue
+     *
+     * @param issueId Issue ID
+     *
+     * @return Handle of the issue, null if the issue is not in use
+     */
+    IssueHandle get( int issueId );
+
+    /**
+     * @brief Get a handle of an empty issue
+     *
+     * @return Handle of an issue without ID
+     */
+    static IssueHandle null();
+
+    /**
+     * @brief Register an issue
+     *
+     * Emits changed() if the issue replaces a different version of the issue.
+     *
+     * @param issue Issue
+     *
+     * @return Handle of the registered issue
+     */
+    IssueHandle update( const qtredmine::Issue& issue );
+
+signals:
+    /**
+     * @brief Emitted when an issue in use has been updated
+     *
+     * @param issue Handle of the updated issue
+     */
+    void changed( IssueHandle issue );
+};
+
+} // redtimer
@@ -0,0 +1,170 @@
+#pragma once
+
+#include "redtimer/IssueIndex.h"
+#include "redtimer/IssueStore.h"
+
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+
+namespace redtimer {
+
+/**
+ * @brief Debounced incremental search over an issue index
+ *
+ * Search queries are collected until the input has been idle for a short delay, so that typing a word
+ * only runs a single search. If a query extends the previous one, e.g. by typing another character, only
+ * the previous matches are searched again since the matches can only become fewer.
+ *
+ * Large indexes are searched in a worker thread on a snapshot of the index. Results of queries that have
+ * been superseded in the meantime are discarded, so finished() is only emitted for the latest query.
+ *
+ * Likewise, issues added to a large index are tokenised into a separate index in a worker thread, which
+ * is then merged into the index. Until then, searches use the previous index; the latest query is searched
+ * again once the new issues are part of the index.
+ */
+class IssueSearch : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Issue index
+    IssueIndex index_;
+
+    /// Index version, increased upon each change of the index
+    quint64 indexVersion_ = 0;
+
+    /// Index epoch, increased upon each clear
+    quint64 epoch_ = 0;
+
+    /// Encoded issues waiting to be added to the index
+    QVector<IssueStore::Block> queued_;
+
+    /// Issues are being added in a worker thread
+    bool indexing_ = false;
+
+    /// Latest query
+    QString query_;
+
+    /// Search generation, increased upon each search
+    quint64 generation_ = 0;
+
+    /// Query of the previous matches
+    QString matchesQuery_;
+
+    /// Previous matches
+    QSet<int> matches_;
+
+    /// Previous matches are based on the current index and can be used to narrow down the search
+    bool matchesValid_ = false;
+
+    /// Index size from which searches are run in a worker thread
+    int threshold_ = 5000;
+
+    /// Timer for debouncing queries
+    QTimer* debounceTimer_ = nullptr;
+
+private:
+    /**
+     * @brief Add the queued issues to the index
+     */
+    void index();
+
+    /**
+     * @brief Merge the index of added issues into the index
+     *
+     * @param epoch Index epoch the issues have been added in
+     * @param index Index of the added issues
+     */
+    void indexed( quint64 epoch, const IssueIndex& index );
+
+    /**
+     * @brief Handle the result of a search
+     *
+     * @param generation Search generation
+     * @param indexVersion Index version that has been searched
+     * @param query Search query
+     * @param issueIds IDs of the matching issues, best match first
+     */
+    void found( quint64 generation, quint64 indexVersion, const QString& query, const QVector<int>& issueIds );
+
+private slots:
+    /**
+     * @brief Run the latest query
+     */
+    void run();
+
+public:
+    /// Default debounce delay in milliseconds
+    static const int DEBOUNCE_DELAY = 150;
+
+    /**
+     * @brief Constructor for an IssueSearch object
+     *
+     * @param parent Parent QObject
+     */
+    explicit IssueSearch( QObject* parent = nullptr );
+
+    /**
+     * @brief Add issues to the index
+     *
+     * The latest query is searched again once the issues have been added.
+     *
+     * @param issues Issues to add
+     */
+    void add( const qtredmine::Issues& issues );
+
+    /**
+     * @brief Add issues encoded for an issue store to the index
+     *
+     * The latest query is searched again once the issues have been added.
+     *
+     * @param block Encoded issues to add
+     */
+    void add( const IssueStore::Block& block );
+
+    /**
+     * @brief Remove all issues from the index
+     */
+    void clear();
+
+    /**
+     * @brief Search for issues once the input has been idle
+     *
+     * An empty query cancels the pending search and emits cleared() at once.
+     *
+     * @param query Search query
+     */
+    void search( const QString& query );
+
+    /**
+     * @brief Set the debounce delay
+     *
+     * @param delay Delay in milliseconds
+     */
+    void setDelay( int delay );
+
+    /**
+     * @brief Set the index size from which searches and additions are run in a worker thread
+     *
+     * @param threshold Number of indexed issues
+     */
+    void setThreshold( int threshold );
+
+signals:
+    /**
+     * @brief Emitted when the query has been cleared
+     */
+    void cleared();
+
+    /**
+     * @brief Emitted when the latest query has been searched
+     *
+     * @param issueIds IDs of the matching issues, best match first
+     */
+    void finished( QVector<int> issueIds );
+};
+
+} // redtimer
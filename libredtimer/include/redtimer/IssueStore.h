@@ -0,0 +1,345 @@
+#pragma once
+
+#include "qtredmine/SimpleRedmineTypes.h"
+
+#include <QByteArray>
+#include <QDate>
+#include <QDateTime>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+namespace redtimer {
+
+/**
+ * @brief Compact column-wise store of issues
+ *
+ * Each issue field is kept in its own column. Referenced items such as the author, project or status are
+ * interned once and referred to by their index; their names are shared through the StringPool.
+ * Descriptions and custom fields are rarely displayed; they are kept out of line in encoded form and only
+ * decoded when accessed. The display text is computed once when an issue is added.
+ *
+ * Issues can be encoded into a Block in a worker thread beforehand, so that inserting them only interns
+ * their items.
+ */
+class IssueStore
+{
+public:
+    /// Item fields of an issue
+    enum Field
+    {
+        AssignedTo,
+        Author,
+        Category,
+        Priority,
+        Project,
+        Status,
+        Tracker,
+        Version,
+        FIELD_COUNT
+    };
+
+    /// Encoded issues that can be inserted into a store, may be created in any thread
+    struct Block
+    {
+        /// @name Columns
+        /// @{
+        QVector<int> ids;
+        QVector<int> parentIds;
+        QVector<qint8> doneRatios;
+        QVector<double> estimatedHours;
+        QVector<QString> subjects;
+        QVector<QString> texts;
+        QVector<qint64> createdOn;
+        QVector<qint64> updatedOn;
+        QVector<qint64> startDates;
+        QVector<qint64> dueDates;
+        QVector<qtredmine::Item> items[FIELD_COUNT];
+        QVector<QByteArray> descriptions;
+        QVector<QByteArray> customFields;
+        /// @}
+
+        /**
+         * @brief Decode the custom fields of an issue
+         *
+         * @param row Row of the issue
+         *
+         * @return Custom fields
+         */
+        qtredmine::CustomFields customFields( int row ) const;
+
+        /**
+         * @brief Decode the description of an issue
+         *
+         * @param row Row of the issue
+         *
+         * @return Description
+         */
+        QString description( int row ) const;
+
+        /**
+         * @brief Remove an issue
+         *
+         * @param row Row of the issue
+         */
+        void remove( int row );
+
+        /**
+         * @brief Get the number of issues
+         *
+         * @return Number of issues
+         */
+        int size() const;
+    };
+
+private:
+    /// @name Columns
+    /// @{
+    QVector<int> ids_;
+    QVector<int> parentIds_;
+    QVector<qint8> doneRatios_;
+    QVector<double> estimatedHours_;
+    QVector<QString> subjects_;
+    QVector<QString> texts_;
+    QVector<qint64> createdOn_;
+    QVector<qint64> updatedOn_;
+    QVector<qint64> startDates_;
+    QVector<qint64> dueDates_;
+    QVector<int> items_[FIELD_COUNT];
+    /// @}
+
+    /// Descriptions in UTF-8 behind a tag byte telling whether they are compressed, empty if there are none
+    QVector<QByteArray> descriptions_;
+
+    /// Serialised custom fields, empty if there are none
+    QVector<QByteArray> customFields_;
+
+    /// Interned items
+    QVector<qtredmine::Item> itemTable_;
+
+    /// Index of each interned item by ID and name ID
+    QHash<QPair<int, int>, int> itemLookup_;
+
+private:
+    /**
+     * @brief Intern an item
+     *
+     * @param item Item to intern
+     *
+     * @return Index of the interned item
+     */
+    int intern( const qtredmine::Item& item );
+
+public:
+    /// Descriptions from this size in bytes on are compressed
+    static const int COMPRESS_THRESHOLD = 256;
+
+    /// @name Getters
+    /// @{
+
+    /**
+     * @brief Get an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Issue with all fields decoded
+     */
+    qtredmine::Issue at( int row ) const;
+
+    /**
+     * @brief Get the creation time of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Creation time
+     */
+    QDateTime createdOn( int row ) const;
+
+    /**
+     * @brief Get the custom fields of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Decoded custom fields
+     */
+    qtredmine::CustomFields customFields( int row ) const;
+
+    /**
+     * @brief Get the description of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Decoded description
+     */
+    QString description( int row ) const;
+
+    /**
+     * @brief Get the done ratio of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Done ratio in percent
+     */
+    int doneRatio( int row ) const;
+
+    /**
+     * @brief Get the due date of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Due date
+     */
+    QDate dueDate( int row ) const;
+
+    /**
+     * @brief Get the estimated hours of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Estimated hours
+     */
+    double estimatedHours( int row ) const;
+
+    /**
+     * @brief Get the ID of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Issue ID
+     */
+    int id( int row ) const;
+
+    /**
+     * @brief Get all issues
+     *
+     * @return Issues with all fields decoded
+     */
+    qtredmine::Issues issues() const;
+
+    /**
+     * @brief Get an item field of an issue
+     *
+     * @param field Item field
+     * @param row Row of the issue
+     *
+     * @return Item
+     */
+    const qtredmine::Item& item( Field field, int row ) const;
+
+    /**
+     * @brief Get the number of issues
+     *
+     * @return Number of issues
+     */
+    int size() const;
+
+    /**
+     * @brief Get the start date of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Start date
+     */
+    QDate startDate( int row ) const;
+
+    /**
+     * @brief Get the subject of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Subject
+     */
+    const QString& subject( int row ) const;
+
+    /**
+     * @brief Get the display text of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Display text consisting of ID and subject
+     */
+    const QString& text( int row ) const;
+
+    /**
+     * @brief Get the update time of an issue
+     *
+     * @param row Row of the issue
+     *
+     * @return Update time
+     */
+    QDateTime updatedOn( int row ) const;
+
+    /// @}
+
+    /// @name Operations
+    /// @{
+
+    /**
+     * @brief Append encoded issues
+     *
+     * @param block Encoded issues to append
+     */
+    void append( const Block& block );
+
+    /**
+     * @brief Append issues
+     *
+     * @param issues Issues to append
+     */
+    void append( const qtredmine::Issues& issues );
+
+    /**
+     * @brief Remove all issues
+     */
+    void clear();
+
+    /**
+     * @brief Insert encoded issues
+     *
+     * @param row Row to insert the issues at
+     * @param block Encoded issues to insert
+     */
+    void insert( int row, const Block& block );
+
+    /**
+     * @brief Insert issues
+     *
+     * @param row Row to insert the issues at
+     * @param issues Issues to insert
+     */
+    void insert( int row, const qtredmine::Issues& issues );
+
+    /**
+     * @brief Remove issues
+     *
+     * Interned items are kept until the store is cleared.
+     *
+     * @param row First row to remove
+     * @param count Number of rows to remove
+     */
+    void remove( int row, int count );
+
+    /**
+     * @brief Replace an issue
+     *
+     * @param row Row of the issue to replace
+     * @param issue New issue
+     */
+    void replace( int row, const qtredmine::Issue& issue );
+
+    /// @}
+
+    /**
+     * @brief Encode issues for inserting them into a store
+     *
+     * Does not depend on a store and may be called from any thread.
+     *
+     * @param issues Issues to encode
+     *
+     * @return Encoded issues
+     */
+    static Block encode( const qtredmine::Issues& issues );
+};
+
+} // redtimer
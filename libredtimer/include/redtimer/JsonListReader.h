@@ -0,0 +1,142 @@
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+
+#include <functional>
+
+namespace redtimer {
+
+/**
+ * @brief Incremental reader for Redmine list responses
+ *
+ * Redmine list responses consist of an object with an array of records, e.g. "issues", and a few scalar
+ * values such as "total_count". The reader is fed the response bytes as they arrive and hands out each
+ * record of the array as soon as it is complete. Only the bytes of the current record are buffered, so the
+ * response is never materialised as a whole.
+ *
+ * Nested objects and arrays other than the record array are skipped; scalar values of the top-level object
+ * are kept and can be retrieved using value().
+ *
+ * feed() does not log, so that a reader may be fed in a worker thread.
+ */
+class JsonListReader
+{
+public:
+    /// Callback for a complete record
+    using RecordCb = std::function<void(const QJsonObject&)>;
+
+private:
+    /// What is being captured
+    enum class Capture
+    {
+        None,
+        Key,
+        Scalar,
+        Record
+    };
+
+    /// Name of the record array
+    QByteArray listKey_;
+
+    /// Record callback
+    RecordCb callback_;
+
+    /// Nesting depth
+    int depth_ = 0;
+
+    /// Inside a string
+    bool inString_ = false;
+
+    /// Previous character was a backslash inside a string
+    bool escape_ = false;
+
+    /// A key of the top-level object is expected
+    bool expectKey_ = false;
+
+    /// A value of the top-level object is expected
+    bool expectValue_ = false;
+
+    /// Inside the record array
+    bool inList_ = false;
+
+    /// Current capture
+    Capture capture_ = Capture::None;
+
+    /// Captured bytes
+    QByteArray buffer_;
+
+    /// Current key of the top-level object
+    QByteArray key_;
+
+    /// Scalar values of the top-level object by key
+    QHash<QByteArray, QByteArray> values_;
+
+    /// Number of records handed out
+    int records_ = 0;
+
+    /// The top-level object has been closed
+    bool atEnd_ = false;
+
+    /// The response is malformed
+    bool error_ = false;
+
+private:
+    /**
+     * @brief Finish the current capture
+     */
+    void finishCapture();
+
+public:
+    /**
+     * @brief Constructor for a JsonListReader object
+     *
+     * @param listKey Name of the record array
+     * @param callback Callback for each complete record
+     */
+    JsonListReader( const QString& listKey, RecordCb callback );
+
+    /**
+     * @brief Check whether the response has been read completely
+     *
+     * @return true if the top-level object has been closed, false otherwise
+     */
+    bool atEnd() const;
+
+    /**
+     * @brief Feed response bytes
+     *
+     * @param data Next bytes of the response
+     *
+     * @return false if the response is malformed, true otherwise
+     */
+    bool feed( const QByteArray& data );
+
+    /**
+     * @brief Check whether the response is malformed
+     *
+     * @return true if the response is malformed, false otherwise
+     */
+    bool hasError() const;
+
+    /**
+     * @brief Get the number of records handed out
+     *
+     * @return Number of records
+     */
+    int records() const;
+
+    /**
+     * @brief Get a scalar value of the top-level object
+     *
+     * @param key Key of the value
+     *
+     * @return Value, undefined if it has not been read
+     */
+    QJsonValue value( const QString& key ) const;
+};
+
+} // redtimer
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "redtimer/RedmineSession.h"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <functional>
+
+namespace redtimer {
+
+/**
+ * @brief Stale-while-revalidate cache for mostly static Redmine enumerations
+ *
+ * Caches activities, issue statuses, trackers and custom fields per profile. Fresh entries are served
+ * without touching the network. Stale entries are served at once and revalidated in the background; if the
+ * revalidated data differ from the cached data, the changed() signal is emitted so that views can reload.
+ *
+ * Each callback passed to a retrieve method is called exactly once.
+ */
+class MetadataCache : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Cache entry
+    struct Entry
+    {
+        /// Serialised data
+        QByteArray data;
+
+        /// Time when the data have been retrieved or revalidated, in UTC
+        QDateTime validated;
+    };
+
+    /// Redmine session
+    RedmineSession* redmine_;
+
+    /// Cache entries
+    QHash<QString, Entry> entries_;
+
+    /// Keys that are currently being revalidated
+    QSet<QString> revalidating_;
+
+    /// Cache file name
+    QString fileName_;
+
+    /// Redmine URL the cached data belong to
+    QString url_;
+
+    /// Time to live in seconds
+    int ttl_ = 3600;
+
+private:
+    /**
+     * @brief Load the cache from the cache file
+     *
+     * @return true if the cache could be loaded, false otherwise
+     */
+    bool load();
+
+    /**
+     * @brief Retrieve data using the cache
+     *
+     * @param key Cache key
+     * @param fetch Function that retrieves the data from Redmine
+     * @param cb Callback function
+     */
+    template<typename T>
+    void retrieve( const QString& key, std::function<void(RedmineCb<T>)> fetch, RedmineCb<T> cb );
+
+    /**
+     * @brief Save the cache to the cache file
+     *
+     * @return true if the cache could be saved, false otherwise
+     */
+    bool save();
+
+    /**
+     * @brief Update a cache entry
+     *
+     * @param key Cache key
+     * @param data Serialised data
+     *
+     * @return true if the data have changed, false otherwise
+     */
+    bool update( const QString& key, const QByteArray& data );
+
+public:
+    /// Version of the cache file format
+    static const quint32 VERSION = 1;
+
+    /**
+     * @brief Constructor for a MetadataCache object
+     *
+     * @param redmine Redmine session
+     * @param parent Parent QObject
+     */
+    explicit MetadataCache( RedmineSession* redmine, QObject* parent = nullptr );
+
+    /**
+     * @brief Mark all entries as stale
+     *
+     * Stale entries will still be served but revalidated upon the next access.
+     */
+    void invalidate();
+
+    /**
+     * @brief Open the cache for a profile
+     *
+     * Does nothing if the cache is already open for the specified profile and URL.
+     *
+     * @param profileId Profile ID
+     * @param url Redmine URL of the profile
+     */
+    void open( int profileId, const QString& url );
+
+    /**
+     * @brief Set the time to live
+     *
+     * @param ttl Time to live in seconds
+     */
+    void setTtl( int ttl );
+
+    /// @name Retrieval
+    /// @{
+
+    /**
+     * @brief Retrieve custom fields
+     *
+     * @param callback Callback function
+     * @param filter Custom field filter
+     */
+    void retrieveCustomFields( RedmineCb<qtredmine::CustomFields> callback,
+                               const qtredmine::CustomFieldFilter& filter );
+
+    /**
+     * @brief Retrieve issue statuses
+     *
+     * @param callback Callback function
+     */
+    void retrieveIssueStatuses( RedmineCb<qtredmine::IssueStatuses> callback );
+
+    /**
+     * @brief Retrieve time entry activities
+     *
+     * @param callback Callback function
+     */
+    void retrieveTimeEntryActivities( RedmineCb<qtredmine::Enumerations> callback );
+
+    /**
+     * @brief Retrieve trackers
+     *
+     * @param callback Callback function
+     */
+    void retrieveTrackers( RedmineCb<qtredmine::Trackers> callback );
+
+    /// @}
+
+signals:
+    /**
+     * @brief Emitted when revalidated data differ from the cached data
+     *
+     * @param key Cache key
+     */
+    void changed( const QString& key );
+};
+
+} // redtimer
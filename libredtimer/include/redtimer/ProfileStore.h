@@ -0,0 +1,135 @@
+#pragma once
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QVariant>
+
+namespace redtimer {
+
+/**
+ * @brief Binary settings store with one file per profile and a profile index
+ *
+ * Each profile is stored as a versioned map of settings keys to values that is read in a single pass.
+ * The profile index lists the IDs and names of all profiles, so that profiles can be enumerated without
+ * reading their settings. Files are replaced atomically.
+ *
+ * Profiles of the former INI settings file are imported when neither the profile index nor any profile file
+ * exists yet.
+ */
+class ProfileStore
+{
+public:
+    /// Entry of the profile index
+    struct Profile
+    {
+        /// Profile ID
+        int id;
+
+        /// Profile name
+        QString name;
+    };
+
+    /// List of profiles
+    using Profiles = QList<Profile>;
+
+    /// Settings of a profile
+    using Values = QMap<QString, QVariant>;
+
+    /// Version of the store file formats
+    static const quint32 VERSION = 1;
+
+private:
+    /**
+     * @brief Get the directory of the store files
+     *
+     * @return Directory path
+     */
+    static QString directory();
+
+    /**
+     * @brief Get the file name of the profile index
+     *
+     * @return File name
+     */
+    static QString indexFileName();
+
+    /**
+     * @brief Import all profiles from the former INI settings file
+     *
+     * @return Imported profiles, empty if there is no INI settings file
+     */
+    static Profiles import();
+
+    /**
+     * @brief Create the profile index from the profile files
+     *
+     * Imports the former INI settings file if there are no profile files yet.
+     *
+     * @return Profiles
+     */
+    static Profiles rebuildIndex();
+
+    /**
+     * @brief Save the profile index
+     *
+     * @param profiles Profiles
+     *
+     * @return true if the profile index has been saved, false otherwise
+     */
+    static bool saveProfiles( const Profiles& profiles );
+
+public:
+    /**
+     * @brief Add a profile to the profile index or rename it
+     *
+     * Does nothing if the profile is already listed with that name.
+     *
+     * @param id Profile ID
+     * @param name Profile name
+     *
+     * @return true if the profile index is up to date, false otherwise
+     */
+    static bool addProfile( int id, const QString& name );
+
+    /**
+     * @brief Get the file name of a profile
+     *
+     * @param profileId Profile ID
+     *
+     * @return File name
+     */
+    static QString fileName( int profileId );
+
+    /**
+     * @brief Load the settings of a profile
+     *
+     * @param profileId Profile ID
+     * @param values Loaded settings, empty if the profile does not exist
+     *
+     * @return true if the settings have been loaded, false otherwise
+     */
+    static bool load( int profileId, Values* values );
+
+    /**
+     * @brief Get all profiles from the profile index
+     *
+     * @return Profiles
+     */
+    static Profiles profiles();
+
+    /**
+     * @brief Save the settings of a profile
+     *
+     * May be called from any thread, but not concurrently for the same profile. Does not log since
+     * qtredmine's logger is not meant to be used from other threads.
+     *
+     * @param profileId Profile ID
+     * @param values Settings
+     *
+     * @return true if the settings have been saved, false otherwise
+     */
+    static bool save( int profileId, const Values& values );
+};
+
+} // redtimer
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "qtredmine/SimpleRedmineTypes.h"
+
+#include <QJsonObject>
+
+namespace redtimer {
+
+/**
+ * @brief Convert a Redmine JSON object into an item
+ *
+ * @param object JSON object
+ * @param item Item to fill
+ */
+void fromJson( const QJsonObject& object, qtredmine::Item& item );
+
+/**
+ * @brief Convert a Redmine JSON object into an issue
+ *
+ * All issues that RedmineSession retrieves are decoded by this function, whether they are retrieved one by
+ * one or streamed, so that the same issue always compares equal. May be called from any thread.
+ *
+ * @param object JSON object
+ * @param issue Issue to fill
+ */
+void fromJson( const QJsonObject& object, qtredmine::Issue& issue );
+
+/**
+ * @brief Convert a time entry into a Redmine JSON object
+ *
+ * @param timeEntry Time entry
+ *
+ * @return JSON object to be sent as "time_entry"
+ */
+QJsonObject toJson( const qtredmine::TimeEntry& timeEntry );
+
+} // redtimer
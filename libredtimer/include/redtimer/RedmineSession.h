@@ -0,0 +1,338 @@
+#pragma once
+
+#include "qtredmine/SimpleRedmineClient.h"
+
+#include <QHash>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <functional>
+#include <memory>
+
+namespace redtimer {
+
+/// Callback for Redmine data of type T
+template<typename T>
+using RedmineCb = std::function<void(T, qtredmine::RedmineError, QStringList)>;
+
+/// Callback for Redmine data of type T that also receives the HTTP status code, zero if there was no response
+template<typename T>
+using RedmineStatusCb = std::function<void(T, qtredmine::RedmineError, int, QStringList)>;
+
+/// Callback for a submission that receives success, HTTP status code, error code and errors
+using SubmitCb = std::function<void(bool, int, qtredmine::RedmineError, QStringList)>;
+
+/// Saved Redmine issue query
+struct SavedQuery
+{
+    /// Query ID
+    int id = NULL_ID;
+
+    /// Query name
+    QString name;
+
+    /// Project ID, NULL_ID for global queries
+    int projectId = NULL_ID;
+};
+
+/// List of saved queries
+using SavedQueries = QVector<SavedQuery>;
+
+/**
+ * @brief Redmine session shared by all windows of a RedTimer process
+ *
+ * Only one session is created per process so that all windows use the same network access manager,
+ * connection pool and TLS session. Identical GET requests that are issued while a previous one is still in
+ * flight are not sent again; instead, their callbacks are attached to the pending request. Requests are
+ * identified by their endpoint and parameters. Changing the URL or the API key detaches all in-flight
+ * requests, so that requests are never shared between servers or users.
+ *
+ * The retrieval methods hide the corresponding methods of SimpleRedmineClient, i.e. requests are only
+ * coalesced when issued through a RedmineSession pointer.
+ */
+class RedmineSession : public qtredmine::SimpleRedmineClient
+{
+    Q_OBJECT
+
+private:
+    /// Callbacks waiting for an in-flight request
+    struct PendingBase
+    {
+        virtual ~PendingBase() = default;
+    };
+
+    template<typename T>
+    struct Pending : public PendingBase
+    {
+        QVector<RedmineCb<T>> callbacks;
+    };
+
+    /// In-flight requests by endpoint and parameters
+    QHash<QString, std::shared_ptr<PendingBase>> inFlight_;
+
+    /// Redmine URL
+    QString url_;
+
+    /// API key
+    QString apiKey_;
+
+    /// Number of requests sent
+    quint64 sent_ = 0;
+
+    /// Number of requests attached to an in-flight request
+    quint64 coalesced_ = 0;
+
+private:
+    /**
+     * @brief Send a request or attach to an identical in-flight request
+     *
+     * @param key Request key consisting of endpoint and parameters
+     * @param callback Callback function
+     * @param send Function that sends the request
+     */
+    template<typename T>
+    void coalesce( const QString& key, RedmineCb<T> callback, std::function<void(RedmineCb<T>)> send );
+
+    /**
+     * @brief Send data to Redmine and report the HTTP status code
+     *
+     * @param resource Resource, e.g. "time_entries"
+     * @param operation HTTP operation
+     * @param data JSON data
+     * @param callback Callback function
+     */
+    void submit( const QString& resource, QNetworkAccessManager::Operation operation, const QJsonObject& data,
+                 SubmitCb callback );
+
+    /**
+     * @brief Retrieve a list record by record and decode the records in worker threads
+     *
+     * @param resource Resource, e.g. "issues"
+     * @param listKey Name of the record array in the response
+     * @param decode Function that decodes a record, called in a worker thread
+     * @param record Callback for each decoded record
+     * @param callback Callback function that receives the total number of records, NULL_ID if unknown
+     * @param parameters Additional parameters
+     */
+    template<typename T>
+    void streamRecords( const QString& resource, const QString& listKey,
+                        std::function<T(const QJsonObject&)> decode, std::function<void(const T&)> record,
+                        RedmineCb<int> callback, const QString& parameters );
+
+public:
+    /**
+     * @brief Constructor for a RedmineSession object
+     *
+     * @param parent Parent QObject
+     */
+    explicit RedmineSession( QObject* parent = nullptr );
+
+    /// @name Getters
+    /// @{
+
+    /**
+     * @brief Get the number of requests that have been attached to an in-flight request
+     *
+     * @return Number of coalesced requests
+     */
+    quint64 coalescedRequests() const;
+
+    /**
+     * @brief Get the number of requests that have actually been sent
+     *
+     * @return Number of sent requests
+     */
+    quint64 sentRequests() const;
+
+    /// @}
+
+    /// @name Setters
+    /// @{
+
+    using qtredmine::SimpleRedmineClient::setAuthenticator;
+
+    /**
+     * @brief Set the API key and detach all in-flight requests
+     *
+     * @param apiKey API key
+     */
+    void setAuthenticator( QString apiKey );
+
+    /**
+     * @brief Set the Redmine URL and detach all in-flight requests
+     *
+     * @param url Redmine URL
+     */
+    void setUrl( QString url );
+
+    /// @}
+
+    /// @name Coalesced retrieval
+    /// @{
+
+    /**
+     * @brief Retrieve the current user
+     *
+     * @param callback Callback function
+     */
+    void retrieveCurrentUser( RedmineCb<qtredmine::User> callback );
+
+    /**
+     * @brief Retrieve custom fields
+     *
+     * @param callback Callback function
+     * @param filter Custom field filter
+     */
+    void retrieveCustomFields( RedmineCb<qtredmine::CustomFields> callback,
+                               const qtredmine::CustomFieldFilter& filter );
+
+    /**
+     * @brief Retrieve an issue
+     *
+     * The callback receives the HTTP status code so that callers can tell an issue that has been deleted or
+     * is not visible (404, 403) from an authentication (401) or network error (0). The error messages
+     * contain the messages of Redmine, if any, and the network error.
+     *
+     * @param callback Callback function
+     * @param issueId Issue ID
+     */
+    void retrieveIssue( RedmineStatusCb<qtredmine::Issue> callback, int issueId );
+
+    /**
+     * @brief Retrieve the number of issues of an issue list
+     *
+     * Only a single issue is transferred, the number is taken from the total count of the list.
+     *
+     * @param callback Callback function
+     * @param parameters Issue filter parameters
+     */
+    void retrieveIssueCount( RedmineCb<int> callback, const QString& parameters = QString() );
+
+    /**
+     * @brief Retrieve issue statuses
+     *
+     * @param callback Callback function
+     */
+    void retrieveIssueStatuses( RedmineCb<qtredmine::IssueStatuses> callback );
+
+    /**
+     * @brief Retrieve the memberships of a project
+     *
+     * @param callback Callback function
+     * @param projectId Project ID
+     * @param parameters Additional parameters
+     */
+    void retrieveMemberships( RedmineCb<qtredmine::Memberships> callback, int projectId,
+                              const QString& parameters = QString() );
+
+    /**
+     * @brief Retrieve a project
+     *
+     * @param callback Callback function
+     * @param projectId Project ID
+     */
+    void retrieveProject( RedmineCb<qtredmine::Project> callback, int projectId );
+
+    /**
+     * @brief Retrieve projects
+     *
+     * @param callback Callback function
+     * @param parameters Additional parameters
+     */
+    void retrieveProjects( RedmineCb<qtredmine::Projects> callback, const QString& parameters = QString() );
+
+    /**
+     * @brief Retrieve the saved issue queries that are visible to the current user
+     *
+     * @param callback Callback function
+     * @param parameters Additional parameters
+     */
+    void retrieveQueries( RedmineCb<SavedQueries> callback, const QString& parameters = QString() );
+
+    /**
+     * @brief Retrieve time entries
+     *
+     * @param callback Callback function
+     * @param parameters Additional parameters
+     */
+    void retrieveTimeEntries( RedmineCb<qtredmine::TimeEntries> callback,
+                              const QString& parameters = QString() );
+
+    /**
+     * @brief Retrieve time entry activities
+     *
+     * @param callback Callback function
+     */
+    void retrieveTimeEntryActivities( RedmineCb<qtredmine::Enumerations> callback );
+
+    /**
+     * @brief Retrieve trackers
+     *
+     * @param callback Callback function
+     */
+    void retrieveTrackers( RedmineCb<qtredmine::Trackers> callback );
+
+    /**
+     * @brief Retrieve the versions of a project
+     *
+     * @param callback Callback function
+     * @param projectId Project ID
+     * @param parameters Additional parameters
+     */
+    void retrieveVersions( RedmineCb<qtredmine::Versions> callback, int projectId,
+                           const QString& parameters = QString() );
+
+    /// @}
+
+    /// @name Submission
+    /// @{
+
+    /**
+     * @brief Set the status of an issue
+     *
+     * Unlike SimpleRedmineClient::sendIssue(), the callback receives the HTTP status code, so that an
+     * update that Redmine rejected can be told from one that could not be delivered.
+     *
+     * @param issueId Issue ID
+     * @param statusId Issue status ID
+     * @param callback Callback function
+     */
+    void submitIssueStatus( int issueId, int statusId, SubmitCb callback );
+
+    /**
+     * @brief Create a time entry
+     *
+     * Unlike SimpleRedmineClient::sendTimeEntry(), the callback receives the HTTP status code, so that a
+     * time entry that Redmine rejected can be told from one that could not be delivered.
+     *
+     * @param timeEntry Time entry
+     * @param callback Callback function
+     */
+    void submitTimeEntry( const qtredmine::TimeEntry& timeEntry, SubmitCb callback );
+
+    /// @}
+
+    /// @name Streamed retrieval
+    /// @{
+
+    /**
+     * @brief Retrieve issues record by record as the response arrives
+     *
+     * The response is parsed in worker threads; the issues are handed out in the thread of the session.
+     * Streamed requests are not coalesced.
+     *
+     * @param record Callback for each issue
+     * @param callback Callback function that receives the total number of issues, NULL_ID if unknown
+     * @param parameters Issue filter parameters, including offset and limit
+     */
+    void streamIssues( std::function<void(const qtredmine::Issue&)> record, RedmineCb<int> callback,
+                       const QString& parameters = QString() );
+
+    /// @}
+};
+
+} // redtimer
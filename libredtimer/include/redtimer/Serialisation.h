@@ -0,0 +1,170 @@
+#pragma once
+
+#include "qtredmine/SimpleRedmineTypes.h"
+
+#include <QDataStream>
+
+/**
+ * @brief QDataStream operators for Redmine entities that are persisted by RedTimer
+ *
+ * Persisted files start with a header of a magic number, the format version and the Redmine URL, which is
+ * written and checked by writeHeader() and readHeader().
+ *
+ * Only the fields that are displayed or sent back to Redmine are serialised. Whenever the set of fields
+ * changes, the version of the files using these operators has to be increased.
+ */
+
+inline QDataStream&
+operator<<( QDataStream& out, const qtredmine::Item& item )
+{
+    out << item.id
+        << item.name;
+
+    return out;
+}
+
+inline QDataStream&
+operator>>( QDataStream& in, qtredmine::Item& item )
+{
+    in >> item.id
+       >> item.name;
+
+    return in;
+}
+
+inline QDataStream&
+operator<<( QDataStream& out, const qtredmine::CustomField& customField )
+{
+    out << customField.id
+        << customField.name
+        << customField.values;
+
+    return out;
+}
+
+inline QDataStream&
+operator>>( QDataStream& in, qtredmine::CustomField& customField )
+{
+    in >> customField.id
+       >> customField.name
+       >> customField.values;
+
+    return in;
+}
+
+inline QDataStream&
+operator<<( QDataStream& out, const qtredmine::Issue& issue )
+{
+    out << issue.id
+        << issue.parentId
+        << issue.subject
+        << issue.description
+        << issue.doneRatio
+        << issue.estimatedHours
+        << issue.assignedTo
+        << issue.author
+        << issue.category
+        << issue.priority
+        << issue.project
+        << issue.status
+        << issue.tracker
+        << issue.version
+        << issue.createdOn
+        << issue.updatedOn
+        << issue.startDate
+        << issue.dueDate
+        << issue.customFields;
+
+    return out;
+}
+
+inline QDataStream&
+operator>>( QDataStream& in, qtredmine::Issue& issue )
+{
+    in >> issue.id
+       >> issue.parentId
+       >> issue.subject
+       >> issue.description
+       >> issue.doneRatio
+       >> issue.estimatedHours
+       >> issue.assignedTo
+       >> issue.author
+       >> issue.category
+       >> issue.priority
+       >> issue.project
+       >> issue.status
+       >> issue.tracker
+       >> issue.version
+       >> issue.createdOn
+       >> issue.updatedOn
+       >> issue.startDate
+       >> issue.dueDate
+       >> issue.customFields;
+
+    return in;
+}
+
+inline QDataStream&
+operator<<( QDataStream& out, const qtredmine::TimeEntry& timeEntry )
+{
+    out << timeEntry.activity
+        << timeEntry.comment
+        << timeEntry.hours
+        << timeEntry.issue
+        << timeEntry.spentOn
+        << timeEntry.customFields;
+
+    return out;
+}
+
+inline QDataStream&
+operator>>( QDataStream& in, qtredmine::TimeEntry& timeEntry )
+{
+    in >> timeEntry.activity
+       >> timeEntry.comment
+       >> timeEntry.hours
+       >> timeEntry.issue
+       >> timeEntry.spentOn
+       >> timeEntry.customFields;
+
+    return in;
+}
+
+namespace redtimer {
+
+/**
+ * @brief Write the header of a persisted file
+ *
+ * @param out Stream to write to
+ * @param magic Magic number of the file type
+ * @param version Version of the file format
+ * @param url Redmine URL that the file belongs to
+ */
+inline void
+writeHeader( QDataStream& out, quint32 magic, quint32 version, const QString& url )
+{
+    out << magic << version << url;
+}
+
+/**
+ * @brief Read the header of a persisted file and check whether it matches
+ *
+ * @param in Stream to read from
+ * @param magic Expected magic number of the file type
+ * @param version Expected version of the file format
+ * @param url Expected Redmine URL
+ *
+ * @return true if the header has been read and matches, false otherwise
+ */
+inline bool
+readHeader( QDataStream& in, quint32 magic, quint32 version, const QString& url )
+{
+    quint32 fileMagic = 0;
+    quint32 fileVersion = 0;
+    QString fileUrl;
+    in >> fileMagic >> fileVersion >> fileUrl;
+
+    return in.status() == QDataStream::Ok && fileMagic == magic && fileVersion == version && fileUrl == url;
+}
+
+} // redtimer
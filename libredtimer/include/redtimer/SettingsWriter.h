@@ -0,0 +1,125 @@
+#pragma once
+
+#include "redtimer/ProfileStore.h"
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QTimer>
+#include <QVariant>
+
+namespace redtimer {
+
+/**
+ * @brief Write-behind writer for the settings of a profile
+ *
+ * Holds the settings of a profile from the ProfileStore in memory. Values are compared with the current
+ * values and the profile is only written if a value has changed. Changes within COALESCE_DELAY
+ * milliseconds are written at once by a worker thread, which replaces the profile file atomically. At
+ * most one write is in flight at a time. The changes of a failed write are kept and written again after
+ * RETRY_DELAY milliseconds.
+ *
+ * Pending changes, including those of a failed write in flight, are written synchronously upon sync() and
+ * upon destruction.
+ */
+class SettingsWriter : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Delay in milliseconds to coalesce changes before writing them
+    static const int COALESCE_DELAY = 500;
+
+    /// Delay in milliseconds before retrying a failed write
+    static const int RETRY_DELAY = 5000;
+
+    /// Profile ID
+    int profileId_;
+
+    /// Current values
+    ProfileStore::Values values_;
+
+    /// Values have changed since they have last been written
+    bool dirty_ = false;
+
+    /// Timer to coalesce changes
+    QTimer* timer_ = nullptr;
+
+    /// Watcher for the write in flight
+    QFutureWatcher<bool>* watcher_ = nullptr;
+
+public:
+    /**
+     * @brief Constructor for a SettingsWriter object
+     *
+     * Reads the current values of the profile.
+     *
+     * @param profileId Profile ID
+     * @param parent Parent QObject
+     */
+    SettingsWriter( int profileId, QObject* parent = nullptr );
+
+    /**
+     * @brief Destructor, writes pending changes
+     */
+    ~SettingsWriter();
+
+    /// @name Getters
+    /// @{
+
+    /**
+     * @brief Check whether changes have not been written yet
+     *
+     * @return true if changes are pending or being written, false otherwise
+     */
+    bool isPending() const;
+
+    /**
+     * @brief Get a value
+     *
+     * @param key Settings key
+     * @param defaultValue Value to return if the key does not exist
+     *
+     * @return Value
+     */
+    QVariant value( const QString& key, const QVariant& defaultValue = QVariant() ) const;
+
+    /// @}
+
+    /// @name Operations
+    /// @{
+
+    /**
+     * @brief Write pending changes in the background at once
+     */
+    void flush();
+
+    /**
+     * @brief Set a value
+     *
+     * Does nothing if the value has not changed.
+     *
+     * @param key Settings key
+     * @param value New value
+     */
+    void setValue( const QString& key, const QVariant& value );
+
+    /**
+     * @brief Write pending changes and wait until they have been written
+     *
+     * @return true if all changes have been written, false otherwise
+     */
+    bool sync();
+
+    /// @}
+
+signals:
+    /**
+     * @brief Emitted when changes have been written in the background
+     *
+     * @param success true if the changes have been written, false otherwise
+     */
+    void written( bool success );
+};
+
+} // redtimer
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+namespace redtimer {
+
+/**
+ * @brief Process-wide pool of interned strings
+ *
+ * Names of trackers, statuses, priorities, projects, categories and users repeat across all issues. The
+ * pool hands out one shared copy of each distinct string, so that equal names share the same buffer by
+ * implicit sharing, and assigns each string an ID so that names can be compared as integers.
+ *
+ * Interned strings are never released, so only names that Redmine hands out should be interned, never text
+ * that the user can edit. The pool is thread-safe.
+ */
+class StringPool
+{
+private:
+    /// Protects all members
+    mutable QMutex mutex_;
+
+    /// ID of each interned string
+    QHash<QString, int> ids_;
+
+    /// Interned strings by ID
+    QVector<QString> strings_;
+
+    /// Number of intern requests
+    quint64 requests_ = 0;
+
+    /// Number of bytes of separate copies that have been replaced by interned strings
+    quint64 bytesSaved_ = 0;
+
+private:
+    /**
+     * @brief Intern a string while the mutex is locked
+     *
+     * @param string String to intern
+     *
+     * @return ID of the interned string
+     */
+    int lookup( const QString& string );
+
+    StringPool() = default;
+    Q_DISABLE_COPY( StringPool )
+
+public:
+    /**
+     * @brief Get the process-wide pool
+     *
+     * @return String pool
+     */
+    static StringPool& instance();
+
+    /**
+     * @brief Get the ID of a string, interning it if necessary
+     *
+     * Equal strings have equal IDs.
+     *
+     * @param string String
+     *
+     * @return String ID
+     */
+    int id( const QString& string );
+
+    /**
+     * @brief Intern a string
+     *
+     * @param string String to intern
+     *
+     * @return Shared copy of the string
+     */
+    QString intern( const QString& string );
+
+    /**
+     * @brief Create a memory report
+     *
+     * @return Number of interned strings, their size and the number of bytes saved by sharing them
+     */
+    QString report() const;
+
+    /**
+     * @brief Get an interned string
+     *
+     * @param id String ID
+     *
+     * @return Interned string, null string if the ID is unknown
+     */
+    QString string( int id ) const;
+};
+
+} // redtimer
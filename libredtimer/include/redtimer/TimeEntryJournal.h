@@ -0,0 +1,345 @@
+#pragma once
+
+#include "redtimer/RedmineSession.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QTimer>
+
+namespace redtimer {
+
+/**
+ * @brief Durable write-ahead queue of time entries and issue status updates
+ *
+ * Every time entry and issue status update is appended to a per-profile journal file and synchronised to
+ * disk before it is sent to Redmine. The journal is replayed in order using a bounded number of parallel
+ * requests; issue status updates are sent on their own so that they are applied in order with respect to
+ * the surrounding time entries. An entry is only acknowledged once Redmine has accepted it, or has rejected
+ * it as too short. If sending fails, the entry stays in the queue and replaying is retried with exponential
+ * backoff, or immediately when replay() is called, e.g. when the connection is back. If Redmine rejects an
+ * entry as invalid (HTTP 422), e.g. because the issue has been closed, the entry is moved to a .rejected
+ * file next to the journal and reported once instead of blocking the entries behind it.
+ *
+ * Every profile and Redmine URL has its own journal. The URL is stored in the journal file so that its
+ * entries are never sent to another Redmine server.
+ *
+ * The journal file is append-only. Records are length-prefixed and checksummed so that a torn write at
+ * the end of the file is detected and discarded. A corrupt record within the file is skipped; the file is
+ * then copied to a .corrupt backup and rewritten from the remaining entries. The file is truncated once
+ * all entries are acknowledged.
+ */
+class TimeEntryJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Journal entry
+    struct Entry
+    {
+        /// Entry type
+        enum class Type : quint8
+        {
+            TimeEntry   = 1,
+            IssueStatus = 2
+        };
+
+        /// Sequence number
+        quint64 seq = 0;
+
+        /// Entry type
+        Type type = Type::TimeEntry;
+
+        /// Time entry, if type is Type::TimeEntry
+        qtredmine::TimeEntry timeEntry;
+
+        /// Issue ID, if type is Type::IssueStatus
+        int issueId = NULL_ID;
+
+        /// Issue status ID, if type is Type::IssueStatus
+        int statusId = NULL_ID;
+    };
+
+private:
+    /// Result of sending an entry
+    enum class Outcome
+    {
+        /// Accepted by Redmine or not to be sent again
+        Done,
+
+        /// Rejected by Redmine as invalid
+        Rejected,
+
+        /// Not delivered, to be sent again
+        Failed
+    };
+
+    /// Redmine session
+    RedmineSession* redmine_;
+
+    /// Journal file name
+    QString fileName_;
+
+    /// Redmine URL of the journal
+    QString url_;
+
+    /// Entries that have not been acknowledged yet, oldest first
+    QList<Entry> pending_;
+
+    /// Next sequence number
+    quint64 nextSeq_ = 1;
+
+    /// Sequence numbers of entries that are currently being sent
+    QSet<quint64> inFlight_;
+
+    /// Sequence numbers of entries whose failure has already been reported
+    QSet<quint64> reported_;
+
+    /// Maximum number of parallel requests
+    int maxParallel_ = 4;
+
+    /// A request of the current round has failed
+    bool failed_ = false;
+
+    /// Current retry delay in milliseconds
+    int backoff_ = 0;
+
+    /// Timer for retrying after a failure
+    QTimer* retryTimer_ = nullptr;
+
+private:
+    /**
+     * @brief Acknowledge an entry
+     *
+     * @param fileName Journal file the entry belongs to
+     * @param seq Sequence number of the entry
+     */
+    void acknowledge( const QString& fileName, quint64 seq );
+
+    /**
+     * @brief Append an entry to the journal
+     *
+     * @param entry Entry to append
+     *
+     * @return true if the entry has been written to disk, false otherwise
+     */
+    bool append( Entry entry );
+
+    /**
+     * @brief Send pending entries up to the parallel request limit
+     */
+    void dispatch();
+
+    /**
+     * @brief Load the journal from the journal file
+     *
+     * @return true if the journal could be loaded, false otherwise
+     */
+    bool load();
+
+    /**
+     * @brief Retry sending after the backoff delay has elapsed
+     */
+    void retry();
+
+    /**
+     * @brief Append a rejected entry to the rejected entries of a journal and synchronise them to disk
+     *
+     * @param fileName Journal file the entry belongs to
+     * @param url Redmine URL of the journal
+     * @param entry Rejected entry
+     *
+     * @return true if the entry has been written, false otherwise
+     */
+    bool reject( const QString& fileName, const QString& url, const Entry& entry ) const;
+
+    /**
+     * @brief Rewrite the journal file from the pending entries
+     *
+     * @return true if the journal file has been replaced, false otherwise
+     */
+    bool rewrite() const;
+
+    /**
+     * @brief Send an entry to Redmine
+     *
+     * @param entry Entry to send
+     */
+    void send( const Entry& entry );
+
+    /**
+     * @brief Handle the result of sending an entry
+     *
+     * Only entries that Redmine rejected as invalid are not sent again; every other failure is retried.
+     *
+     * @param fileName Journal file the entry belongs to
+     * @param url Redmine URL of the journal
+     * @param entry Sent entry
+     * @param success Redmine accepted the entry
+     * @param status HTTP status code, zero if there has been no response
+     * @param errorCode Redmine error code
+     * @param errors Error messages
+     */
+    void sent( const QString& fileName, const QString& url, const Entry& entry, bool success, int status,
+               qtredmine::RedmineError errorCode, const QStringList& errors );
+
+    /**
+     * @brief Acknowledge or reschedule a sent entry and report the result
+     *
+     * @param fileName Journal file the entry belongs to
+     * @param url Redmine URL of the journal
+     * @param entry Sent entry
+     * @param outcome Result of sending the entry
+     * @param success Redmine accepted the entry
+     * @param errorCode Redmine error code
+     * @param errors Error messages
+     */
+    void settle( const QString& fileName, const QString& url, const Entry& entry, Outcome outcome,
+                 bool success, qtredmine::RedmineError errorCode, const QStringList& errors );
+
+    /**
+     * @brief Append a record to a journal file and synchronise it to disk
+     *
+     * @param fileName Journal file name
+     * @param record Serialised record
+     *
+     * @return true if the record has been written, false otherwise
+     */
+    bool write( const QString& fileName, const QByteArray& record ) const;
+
+public:
+    /// Version of the journal file format
+    static const quint32 VERSION = 1;
+
+    /// Initial retry delay in milliseconds
+    static const int MIN_BACKOFF = 1000;
+
+    /// Maximum retry delay in milliseconds
+    static const int MAX_BACKOFF = 300000;
+
+    /**
+     * @brief Constructor for a TimeEntryJournal object
+     *
+     * @param redmine Redmine session
+     * @param parent Parent QObject
+     */
+    explicit TimeEntryJournal( RedmineSession* redmine, QObject* parent = nullptr );
+
+    /**
+     * @brief Append an issue status update
+     *
+     * @param issueId Issue ID
+     * @param statusId Issue status ID
+     *
+     * @return true if the update has been written to disk, false otherwise
+     */
+    bool appendIssueStatus( int issueId, int statusId );
+
+    /**
+     * @brief Append a time entry
+     *
+     * @param timeEntry Time entry
+     *
+     * @return true if the time entry has been written to disk, false otherwise
+     */
+    bool appendTimeEntry( const qtredmine::TimeEntry& timeEntry );
+
+    /**
+     * @brief Check whether all entries have been acknowledged
+     *
+     * @return true if there are no pending entries, false otherwise
+     */
+    bool isEmpty() const;
+
+    /**
+     * @brief Open the journal for a profile and Redmine URL
+     *
+     * Does nothing if the journal is already open for the specified profile and URL. Entries of other
+     * profiles or URLs remain in their journals until that profile and URL are opened again.
+     *
+     * @param profileId Profile ID
+     * @param url Redmine URL of the profile
+     */
+    void open( int profileId, const QString& url );
+
+    /**
+     * @brief Send pending entries to Redmine in order
+     *
+     * Cancels a scheduled retry and starts sending at once. Entries that are already being sent are not
+     * sent again.
+     */
+    void replay();
+
+    /**
+     * @brief Set the maximum number of parallel requests
+     *
+     * @param maxParallel Maximum number of parallel requests
+     */
+    void setMaxParallel( int maxParallel );
+
+    /**
+     * @brief Get the number of pending entries
+     *
+     * @return Number of pending entries
+     */
+    int size() const;
+
+signals:
+    /**
+     * @brief Emitted when all entries of the open journal have been acknowledged
+     */
+    void drained();
+
+    /**
+     * @brief Emitted when Redmine has rejected an issue status update
+     *
+     * The update has been moved from the journal to the rejected entries.
+     *
+     * @param issueId Issue ID
+     * @param statusId Issue status ID
+     * @param errors Error messages
+     */
+    void issueStatusRejected( int issueId, int statusId, QStringList errors );
+
+    /**
+     * @brief Emitted when an issue status update has been sent
+     *
+     * Failed attempts are only reported upon the first failure of an update.
+     *
+     * @param issueId Issue ID
+     * @param statusId Issue status ID
+     * @param success Redmine accepted the update
+     * @param errorCode Redmine error code
+     * @param errors Error messages
+     */
+    void issueStatusSent( int issueId, int statusId, bool success, qtredmine::RedmineError errorCode,
+                          QStringList errors );
+
+    /**
+     * @brief Emitted when Redmine has rejected a time entry
+     *
+     * The time entry has been moved from the journal to the rejected entries.
+     *
+     * @param timeEntry Time entry
+     * @param errors Error messages
+     */
+    void timeEntryRejected( qtredmine::TimeEntry timeEntry, QStringList errors );
+
+    /**
+     * @brief Emitted when a time entry has been sent
+     *
+     * Failed attempts are only reported upon the first failure of a time entry.
+     *
+     * @param timeEntry Time entry
+     * @param success Redmine accepted the time entry
+     * @param errorCode Redmine error code
+     * @param errors Error messages
+     */
+    void timeEntrySent( qtredmine::TimeEntry timeEntry, bool success, qtredmine::RedmineError errorCode,
+                        QStringList errors );
+};
+
+} // redtimer
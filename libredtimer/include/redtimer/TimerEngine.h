@@ -0,0 +1,158 @@
+#pragma once
+
+#include <QtGlobal>
+
+#include <functional>
+
+namespace redtimer {
+
+/**
+ * @brief Time tracking engine based on a monotonic clock
+ *
+ * Tracked time consists of closed segments between start() and stop(), the running segment and a manual
+ * adjustment. Segments are measured with a monotonic clock, so that changes of the wall clock do not
+ * affect the tracked time.
+ *
+ * A boot clock, which keeps running while the system is suspended, is only used to detect suspend/resume
+ * gaps: the monotonic clock does not advance while the system is suspended and falls behind the boot
+ * clock. Gaps above SUSPEND_THRESHOLD are reported by suspended() and are not part of the tracked time.
+ * Changes of the wall clock are never taken for a suspend. Where no boot clock is available, no suspend is
+ * detected.
+ *
+ * Both clocks can be injected, e.g. for tests and benchmarks. Reading the elapsed time does not allocate.
+ */
+class TimerEngine
+{
+public:
+    /// Clock returning milliseconds since an arbitrary reference
+    using Clock = std::function<qint64()>;
+
+    /// Minimum difference between boot clock and monotonic clock in milliseconds that is a suspend gap
+    static const qint64 SUSPEND_THRESHOLD = 60000;
+
+private:
+    /// Monotonic clock
+    Clock monotonic_;
+
+    /// Boot clock
+    Clock boot_;
+
+    /// Time is being tracked
+    bool running_ = false;
+
+    /// Monotonic time when the running segment has been started
+    qint64 segmentStart_ = 0;
+
+    /// Boot time when the running segment has been started
+    qint64 segmentBootStart_ = 0;
+
+    /// Tracked time of the closed segments in milliseconds
+    qint64 accumulated_ = 0;
+
+    /// Manual adjustment of the tracked time in milliseconds (may be negative)
+    qint64 adjustment_ = 0;
+
+    /// Suspend gaps of the closed segments in milliseconds
+    qint64 suspended_ = 0;
+
+private:
+    /**
+     * @brief Get the suspend gap of the running segment
+     *
+     * @return Suspend gap in milliseconds, 0 if below SUSPEND_THRESHOLD or not running
+     */
+    qint64 segmentGap() const;
+
+public:
+    /**
+     * @brief Constructor for a TimerEngine object
+     *
+     * @param monotonic Monotonic clock
+     * @param boot Boot clock
+     */
+    explicit TimerEngine( Clock monotonic = monotonicClock, Clock boot = bootClock );
+
+    /// @name Getters
+    /// @{
+
+    /**
+     * @brief Get the process-wide boot clock
+     *
+     * Falls back to the monotonic clock if the system has no clock that keeps running while suspended.
+     *
+     * @return Milliseconds since an arbitrary reference, including suspended time
+     */
+    static qint64 bootClock();
+
+    /**
+     * @brief Get the tracked time
+     *
+     * @return Tracked time in milliseconds, including the adjustment
+     */
+    qint64 elapsed() const;
+
+    /**
+     * @brief Check whether time is being tracked
+     *
+     * @return true if the engine is running, false otherwise
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Get the process-wide monotonic clock
+     *
+     * @return Milliseconds since the first call
+     */
+    static qint64 monotonicClock();
+
+    /**
+     * @brief Get the tracked time in seconds
+     *
+     * @return Tracked time in whole seconds, including the adjustment
+     */
+    int seconds() const;
+
+    /**
+     * @brief Get the detected suspend gaps
+     *
+     * @return Suspended time in milliseconds since the last reset
+     */
+    qint64 suspended() const;
+
+    /// @}
+
+    /// @name Operations
+    /// @{
+
+    /**
+     * @brief Reset the tracked time to zero
+     *
+     * A running engine keeps running with a new segment.
+     */
+    void reset();
+
+    /**
+     * @brief Adjust the tracked time
+     *
+     * @param msecs New tracked time in milliseconds
+     */
+    void setElapsed( qint64 msecs );
+
+    /**
+     * @brief Start a new segment
+     *
+     * Does nothing if the engine is already running.
+     */
+    void start();
+
+    /**
+     * @brief Close the running segment
+     *
+     * Does nothing if the engine is not running.
+     */
+    void stop();
+
+    /// @}
+};
+
+} // redtimer
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "qtredmine/SimpleRedmineTypes.h"
+
+#include <QList>
+#include <QString>
+
+namespace redtimer {
+
+/**
+ * @brief Last rendered state of the main window
+ *
+ * The snapshot is saved on exit and lets the main window paint its previous state at once upon the next
+ * start, before the data has been reloaded from Redmine. Like the issue cache, it is stored per profile in
+ * the user's cache directory and is discarded whenever the profile points to another Redmine instance.
+ */
+class UiSnapshot
+{
+private:
+    /// Snapshot file name
+    QString fileName_;
+
+    /// Redmine URL the snapshot belongs to
+    QString url_;
+
+private:
+    /**
+     * @brief Load the snapshot from the snapshot file
+     *
+     * @return true if the snapshot could be loaded, false otherwise
+     */
+    bool load();
+
+public:
+    /// Version of the snapshot file format
+    static const quint32 VERSION = 1;
+
+    /// Displayed issue
+    qtredmine::Issue issue;
+
+    /// Entries of the activity list
+    QList<qtredmine::Item> activities;
+
+    /// Selected activity index
+    int activityIndex = 0;
+
+    /// Entries of the issue status list
+    QList<qtredmine::Item> issueStatuses;
+
+    /// Selected issue status index
+    int issueStatusIndex = 0;
+
+public:
+    /// @name Getters
+    /// @{
+
+    /**
+     * @brief Check whether the snapshot contains anything to display
+     *
+     * @return true if the snapshot is empty, false otherwise
+     */
+    bool isEmpty() const;
+
+    /// @}
+
+    /// @name Operations
+    /// @{
+
+    /**
+     * @brief Reset the snapshot to an empty state
+     */
+    void clear();
+
+    /**
+     * @brief Open the snapshot of a profile
+     *
+     * Loads the snapshot file unless the profile and URL are already open.
+     *
+     * @param profileId Profile ID
+     * @param url Redmine URL of the profile
+     */
+    void open( int profileId, const QString& url );
+
+    /**
+     * @brief Save the snapshot to the snapshot file
+     *
+     * @return true if the snapshot has been saved, false otherwise
+     */
+    bool save();
+
+    /// @}
+};
+
+} // redtimer
@@ -5,9 +5,46 @@ TEMPLATE = lib
 CONFIG += staticlib
 CONFIG += c++14
 
-HEADERS += include/redtimer/CliOptions.h
+HEADERS += \
+    include/redtimer/CliOptions.h \
+    include/redtimer/IssueCache.h \
+    include/redtimer/IssueFilter.h \
+    include/redtimer/IssueIndex.h \
+    include/redtimer/IssueListLoader.h \
+    include/redtimer/IssueRegistry.h \
+    include/redtimer/IssueSearch.h \
+    include/redtimer/IssueStore.h \
+    include/redtimer/JsonListReader.h \
+    include/redtimer/MetadataCache.h \
+    include/redtimer/ProfileStore.h \
+    include/redtimer/RedmineJson.h \
+    include/redtimer/RedmineSession.h \
+    include/redtimer/Serialisation.h \
+    include/redtimer/SettingsWriter.h \
+    include/redtimer/StringPool.h \
+    include/redtimer/TimeEntryJournal.h \
+    include/redtimer/TimerEngine.h \
+    include/redtimer/UiSnapshot.h
 
-SOURCES += CliOptions.cpp
+SOURCES += \
+    CliOptions.cpp \
+    IssueCache.cpp \
+    IssueFilter.cpp \
+    IssueIndex.cpp \
+    IssueListLoader.cpp \
+    IssueRegistry.cpp \
+    IssueSearch.cpp \
+    IssueStore.cpp \
+    JsonListReader.cpp \
+    MetadataCache.cpp \
+    ProfileStore.cpp \
+    RedmineJson.cpp \
+    RedmineSession.cpp \
+    SettingsWriter.cpp \
+    StringPool.cpp \
+    TimeEntryJournal.cpp \
+    TimerEngine.cpp \
+    UiSnapshot.cpp
 
 DISTFILES += \
     libredtimer.pri \
@@ -4,15 +4,18 @@ SUBDIRS = \
     cli \
     gui \
     libqtredmine \
-    libredtimer
+    libredtimer \
+    tests
 
 cli.file = cli/redtimercli.pro
 gui.file = gui/redtimer.pro
 libqtredmine.file = libqtredmine/qtredmine.pro
+tests.file = tests/tests.pro
 
 cli.depends = libqtredmine libredtimer
 gui.depends = libredtimer
 libredtimer.depends = libqtredmine
+tests.depends = libqtredmine libredtimer
 
 DISTFILES += \
     deploy/* \
@@ -0,0 +1,6 @@
+TARGET = tst_issuecache
+
+SOURCES += \
+    IssueCacheTest.cpp
+
+include($$PWD/../tests.pri)
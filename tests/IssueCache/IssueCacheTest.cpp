@@ -0,0 +1,95 @@
+#include "redtimer/IssueCache.h"
+
+#include <QDir>
+#include <QStandardPaths>
+#include <QtTest>
+
+using namespace qtredmine;
+using namespace redtimer;
+
+/**
+ * @brief Tests of the IssueCache
+ */
+class IssueCacheTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Redmine URL of the cache
+    static const QString URL;
+
+    /**
+     * @brief Create an issue
+     *
+     * @param statusId Issue status ID
+     * @param updatedOn Time stamp of the last update
+     *
+     * @return Issue
+     */
+    static Issue issue( int statusId, const QDateTime& updatedOn )
+    {
+        Issue issue;
+        issue.id = 7;
+        issue.subject = "Subject";
+        issue.status.id = statusId;
+        issue.updatedOn = updatedOn;
+        return issue;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled( true );
+    }
+
+    void init()
+    {
+        QDir( QStandardPaths::writableLocation(QStandardPaths::CacheLocation) ).removeRecursively();
+    }
+
+    void insert()
+    {
+        QDateTime updatedOn( QDate(2024, 1, 2), QTime(10, 0), Qt::UTC );
+
+        IssueCache cache;
+        cache.open( 1, URL );
+        QVERIFY( cache.insert(issue(1, updatedOn)) );
+
+        // An issue that has not been updated in Redmine is not stored again
+        QVERIFY( !cache.insert(issue(2, updatedOn)) );
+        QCOMPARE( cache.issue(7).status.id, 1 );
+
+        QVERIFY( cache.insert(issue(2, updatedOn.addSecs(60))) );
+        QCOMPARE( cache.issue(7).status.id, 2 );
+    }
+
+    void insertUnconfirmed()
+    {
+        QDateTime updatedOn( QDate(2024, 1, 2), QTime(10, 0), Qt::UTC );
+
+        {
+            IssueCache cache;
+            cache.open( 1, URL );
+            QVERIFY( cache.insert(issue(1, updatedOn)) );
+
+            // A local change is stored although the time stamp is the same
+            cache.insertUnconfirmed( issue(2, updatedOn) );
+            QCOMPARE( cache.issue(7).status.id, 2 );
+        }
+
+        IssueCache cache;
+        cache.open( 1, URL );
+        QCOMPARE( cache.issue(7).status.id, 2 );
+
+        // The unchanged issue from Redmine replaces the local change, e.g. if Redmine has rejected it
+        QVERIFY( cache.insert(issue(1, updatedOn)) );
+        QCOMPARE( cache.issue(7).status.id, 1 );
+        QCOMPARE( cache.issue(7).updatedOn, updatedOn );
+    }
+};
+
+const QString IssueCacheTest::URL = "https://redmine.example.com";
+
+QTEST_GUILESS_MAIN( IssueCacheTest )
+
+#include "IssueCacheTest.moc"
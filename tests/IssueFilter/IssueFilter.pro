@@ -0,0 +1,6 @@
+TARGET = tst_issuefilter
+
+SOURCES += \
+    IssueFilterTest.cpp
+
+include($$PWD/../tests.pri)
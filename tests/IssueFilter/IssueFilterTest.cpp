@@ -0,0 +1,116 @@
+#include "redtimer/IssueFilter.h"
+
+#include <QtTest>
+
+using namespace redtimer;
+
+/**
+ * @brief Tests of the IssueFilter parameters
+ */
+class IssueFilterTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void empty()
+    {
+        IssueFilter filter;
+        QVERIFY( filter.isEmpty() );
+        QCOMPARE( filter.parameters(), QString() );
+
+        // Blank subjects are no filter
+        filter.subject = "  ";
+        QVERIFY( filter.isEmpty() );
+    }
+
+    void statuses_data()
+    {
+        QTest::addColumn<int>( "statusId" );
+        QTest::addColumn<QString>( "parameters" );
+
+        QTest::newRow( "open" )   << (int)IssueFilter::OPEN_STATUSES   << "status_id=open";
+        QTest::newRow( "closed" ) << (int)IssueFilter::CLOSED_STATUSES << "status_id=closed";
+        QTest::newRow( "all" )    << (int)IssueFilter::ALL_STATUSES    << "status_id=*";
+        QTest::newRow( "status" ) << 5                                 << "status_id=5";
+    }
+
+    void statuses()
+    {
+        QFETCH( int, statusId );
+        QFETCH( QString, parameters );
+
+        IssueFilter filter;
+        filter.statusId = statusId;
+        QCOMPARE( filter.parameters(), parameters );
+    }
+
+    void updatedOn_data()
+    {
+        QTest::addColumn<QDate>( "from" );
+        QTest::addColumn<QDate>( "to" );
+        QTest::addColumn<QString>( "parameters" );
+
+        QTest::newRow( "from" ) << QDate(2024, 1, 2) << QDate()
+                                << "updated_on=%3E%3D2024-01-02";
+        QTest::newRow( "to" ) << QDate() << QDate(2024, 2, 29)
+                              << "updated_on=%3C%3D2024-02-29";
+        QTest::newRow( "range" ) << QDate(2024, 1, 2) << QDate(2024, 2, 29)
+                                 << "updated_on=%3E%3C2024-01-02%7C2024-02-29";
+    }
+
+    void updatedOn()
+    {
+        QFETCH( QDate, from );
+        QFETCH( QDate, to );
+        QFETCH( QString, parameters );
+
+        IssueFilter filter;
+        filter.updatedFrom = from;
+        filter.updatedTo = to;
+        QCOMPARE( filter.parameters(), parameters );
+    }
+
+    void encoding()
+    {
+        IssueFilter filter;
+        filter.subject = " Fix a&b=c #1 100% ";
+        filter.customFields.insert( 7, "x y/z" );
+        filter.customFields.insert( 3, "\xc3\xa4+?" );
+
+        // Only unreserved characters are kept, custom fields are ordered by ID
+        QCOMPARE( filter.parameters(),
+                  QString("subject=~Fix%20a%26b%3Dc%20%231%20100%25&cf_3=%C3%A4%2B%3F&cf_7=x%20y%2Fz") );
+    }
+
+    void order()
+    {
+        IssueFilter filter;
+        filter.queryId = 4;
+        filter.statusId = IssueFilter::OPEN_STATUSES;
+        filter.trackerId = 2;
+        filter.updatedFrom = QDate( 2024, 1, 2 );
+        filter.subject = "abc";
+        filter.customFields.insert( 1, "v" );
+
+        QVERIFY( !filter.isEmpty() );
+        QCOMPARE( filter.parameters(), QString("query_id=4&status_id=open&tracker_id=2"
+                                               "&updated_on=%3E%3D2024-01-02&subject=~abc&cf_1=v") );
+    }
+
+    void searchText()
+    {
+        IssueFilter filter;
+        filter.setSearchText( "  login cf_3:abc  error cf_12=x:y cf_:z " );
+
+        QCOMPARE( filter.subject, QString("login error cf_:z") );
+        QCOMPARE( filter.customFields.size(), 2 );
+        QCOMPARE( filter.customFields.value(3), QString("abc") );
+        QCOMPARE( filter.customFields.value(12), QString("x:y") );
+
+        QCOMPARE( IssueFilter::localSearchText("login cf_3:abc error"), QString("login error") );
+    }
+};
+
+QTEST_GUILESS_MAIN( IssueFilterTest )
+
+#include "IssueFilterTest.moc"
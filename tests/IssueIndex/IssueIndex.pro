@@ -0,0 +1,6 @@
+TARGET = tst_issueindex
+
+SOURCES += \
+    IssueIndexTest.cpp
+
+include($$PWD/../tests.pri)
@@ -0,0 +1,93 @@
+#include "redtimer/IssueIndex.h"
+
+#include <QtTest>
+
+using namespace qtredmine;
+using namespace redtimer;
+
+/**
+ * @brief Tests of the IssueIndex with issues and encoded issues
+ */
+class IssueIndexTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    /**
+     * @brief Create issues with searchable text in every indexed field
+     *
+     * @return Issues
+     */
+    static Issues issues()
+    {
+        Issue first;
+        first.id = 11;
+        first.subject = "Login fails";
+
+        Issue second;
+        second.id = 12;
+        second.subject = "Export";
+        second.description = QString( IssueStore::COMPRESS_THRESHOLD, 'x' ) + " timeout";
+
+        CustomField customField;
+        customField.id = 3;
+        customField.values = QStringList{ "customer", "42" };
+
+        Issue third;
+        third.id = 13;
+        third.subject = "Report";
+        third.customFields.push_back( customField );
+
+        return Issues{ first, second, third };
+    }
+
+private slots:
+    void block_data()
+    {
+        QTest::addColumn<QString>( "query" );
+        QTest::addColumn<QVector<int>>( "issueIds" );
+
+        QTest::newRow( "id" )           << "12"      << QVector<int>{12};
+        QTest::newRow( "subject" )      << "log"     << QVector<int>{11};
+        QTest::newRow( "description" )  << "timeout" << QVector<int>{12};
+        QTest::newRow( "custom field" ) << "cust 42" << QVector<int>{13};
+    }
+
+    void block()
+    {
+        QFETCH( QString, query );
+        QFETCH( QVector<int>, issueIds );
+
+        IssueIndex issueIndex;
+        issueIndex.add( issues() );
+
+        // Encoded issues are indexed like the issues themselves, including compressed descriptions
+        IssueIndex blockIndex;
+        blockIndex.add( IssueStore::encode(issues()) );
+
+        QCOMPARE( blockIndex.size(), 3 );
+        QCOMPARE( issueIndex.search(query), issueIds );
+        QCOMPARE( blockIndex.search(query), issueIds );
+    }
+
+    void removeFromBlock()
+    {
+        IssueStore::Block block = IssueStore::encode( issues() );
+        block.remove( 1 );
+
+        QCOMPARE( block.size(), 2 );
+        QCOMPARE( block.ids, (QVector<int>{11, 13}) );
+        QCOMPARE( block.subjects.size(), 2 );
+        QCOMPARE( block.descriptions.size(), 2 );
+        QCOMPARE( block.customFields(1).size(), 1 );
+
+        IssueIndex index;
+        index.add( block );
+        QVERIFY( index.contains(13) );
+        QVERIFY( !index.contains(12) );
+    }
+};
+
+QTEST_GUILESS_MAIN( IssueIndexTest )
+
+#include "IssueIndexTest.moc"
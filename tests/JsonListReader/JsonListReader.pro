@@ -0,0 +1,6 @@
+TARGET = tst_jsonlistreader
+
+SOURCES += \
+    JsonListReaderTest.cpp
+
+include($$PWD/../tests.pri)
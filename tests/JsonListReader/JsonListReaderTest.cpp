@@ -0,0 +1,148 @@
+#include "redtimer/JsonListReader.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtTest>
+
+using namespace redtimer;
+
+/**
+ * @brief Tests of the JsonListReader with responses split into chunks
+ */
+class JsonListReaderTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Response with strings that contain escapes and JSON syntax
+    static const QByteArray RESPONSE;
+
+    /**
+     * @brief Read a response chunk by chunk
+     *
+     * @param chunks Response chunks
+     * @param records Records that have been handed out
+     * @param total Value of total_count
+     *
+     * @return true if the response has been read completely and without error, false otherwise
+     */
+    static bool read( const QList<QByteArray>& chunks, QList<QJsonObject>* records, QJsonValue* total )
+    {
+        JsonListReader reader( "issues", [=]( const QJsonObject& record ){ records->append( record ); } );
+
+        for( const auto& chunk : chunks )
+            if( !reader.feed(chunk) )
+                return false;
+
+        *total = reader.value( "total_count" );
+
+        return reader.atEnd() && !reader.hasError() && reader.records() == records->size();
+    }
+
+    /**
+     * @brief Get the records of the response using QJsonDocument
+     *
+     * @return Records
+     */
+    static QList<QJsonObject> expected()
+    {
+        QList<QJsonObject> records;
+        for( const auto& record : QJsonDocument::fromJson(RESPONSE).object().value("issues").toArray() )
+            records.append( record.toObject() );
+
+        return records;
+    }
+
+private slots:
+    void wholeResponse()
+    {
+        QList<QJsonObject> records;
+        QJsonValue total;
+        QVERIFY( read({RESPONSE}, &records, &total) );
+
+        QCOMPARE( records.size(), 3 );
+        QCOMPARE( records, expected() );
+        QCOMPARE( total.toInt(), 42 );
+    }
+
+    void twoChunks()
+    {
+        QList<QJsonObject> expected = this->expected();
+
+        // Split the response at every position, including inside strings and escapes
+        for( int split = 0; split <= RESPONSE.size(); ++split )
+        {
+            QList<QJsonObject> records;
+            QJsonValue total;
+            QVERIFY2( read({RESPONSE.left(split), RESPONSE.mid(split)}, &records, &total),
+                      qPrintable(QString("Split at %1").arg(split)) );
+
+            QCOMPARE( records, expected );
+            QCOMPARE( total.toInt(), 42 );
+        }
+    }
+
+    void singleBytes()
+    {
+        QList<QByteArray> chunks;
+        for( char c : RESPONSE )
+            chunks.append( QByteArray(1, c) );
+
+        QList<QJsonObject> records;
+        QJsonValue total;
+        QVERIFY( read(chunks, &records, &total) );
+
+        QCOMPARE( records, expected() );
+        QCOMPARE( total.toInt(), 42 );
+    }
+
+    void scalarValues()
+    {
+        JsonListReader reader( "issues", []( const QJsonObject& ){} );
+        QVERIFY( reader.feed(RESPONSE) );
+
+        QCOMPARE( reader.value("offset").toInt(), 25 );
+        QCOMPARE( reader.value("limit").toInt(), 3 );
+        QCOMPARE( reader.value("comment").toString(), QString("a \"b\" [c], {d}") );
+        QVERIFY( reader.value("skipped").isUndefined() );
+        QVERIFY( reader.value("unknown").isUndefined() );
+    }
+
+    void malformed()
+    {
+        JsonListReader reader( "issues", []( const QJsonObject& ){} );
+        QVERIFY( !reader.feed("{\"issues\":[{\"id\":1}]}}") );
+        QVERIFY( reader.hasError() );
+
+        // A malformed response stays malformed
+        QVERIFY( !reader.feed("{}") );
+    }
+
+    void incomplete()
+    {
+        QList<QJsonObject> records;
+        JsonListReader reader( "issues", [&]( const QJsonObject& record ){ records.append( record ); } );
+
+        QVERIFY( reader.feed(RESPONSE.left(RESPONSE.indexOf("\"id\":3"))) );
+        QVERIFY( !reader.atEnd() );
+        QCOMPARE( records.size(), 2 );
+    }
+};
+
+const QByteArray JsonListReaderTest::RESPONSE =
+        "{\n"
+        "  \"comment\": \"a \\\"b\\\" [c], {d}\",\n"
+        "  \"skipped\": {\"issues\": [{\"id\": 99}], \"text\": \"}]\"},\n"
+        "  \"issues\": [\n"
+        "    {\"id\":1,\"subject\":\"Quote \\\" and backslash \\\\\",\"project\":{\"id\":2,\"name\":\"P\"}},\n"
+        "    {\"id\":2,\"subject\":\"Braces } { and brackets ] [\",\"custom_fields\":[{\"id\":1,\"value\":[\"a\",\"b\"]}]},\n"
+        "    {\"id\":3,\"subject\":\"Unicode \\u00e4\\u00f6 \\\\\\\"\",\"description\":\"Line\\nbreak\\t\\/\"}\n"
+        "  ],\n"
+        "  \"total_count\": 42,\n"
+        "  \"offset\": 25,\n"
+        "  \"limit\": 3\n"
+        "}\n";
+
+QTEST_GUILESS_MAIN( JsonListReaderTest )
+
+#include "JsonListReaderTest.moc"
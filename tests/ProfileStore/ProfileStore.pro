@@ -0,0 +1,6 @@
+TARGET = tst_profilestore
+
+SOURCES += \
+    ProfileStoreTest.cpp
+
+include($$PWD/../tests.pri)
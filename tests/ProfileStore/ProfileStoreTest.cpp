@@ -0,0 +1,135 @@
+#include "redtimer/ProfileStore.h"
+
+#include <QDir>
+#include <QSettings>
+#include <QStandardPaths>
+#include <QTemporaryDir>
+#include <QtTest>
+
+using namespace redtimer;
+
+/**
+ * @brief Tests of the ProfileStore import of the former INI settings file
+ */
+class ProfileStoreTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Directory of the former INI settings file
+    QTemporaryDir iniDir_;
+
+    /**
+     * @brief Get the former INI settings file
+     *
+     * @return Settings
+     */
+    static QSettings* iniSettings()
+    {
+        return new QSettings( QSettings::IniFormat, QSettings::UserScope, "Thomssen IT", "RedTimer" );
+    }
+
+    /**
+     * @brief Get the directory of the store files
+     *
+     * @return Directory
+     */
+    static QDir storeDirectory()
+    {
+        QDir dir( QStandardPaths::writableLocation(QStandardPaths::GenericConfigLocation) );
+        return QDir( dir.filePath("Thomssen IT/RedTimer") );
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY( iniDir_.isValid() );
+
+        QStandardPaths::setTestModeEnabled( true );
+        QSettings::setPath( QSettings::IniFormat, QSettings::UserScope, iniDir_.path() );
+    }
+
+    void init()
+    {
+        // Start without profile index, profile files and INI settings
+        storeDirectory().removeRecursively();
+
+        QScopedPointer<QSettings> settings( iniSettings() );
+        settings->clear();
+        settings->sync();
+    }
+
+    void noSettings()
+    {
+        QVERIFY( ProfileStore::profiles().isEmpty() );
+    }
+
+    void import()
+    {
+        QScopedPointer<QSettings> settings( iniSettings() );
+        settings->setValue( "profile-1/name", "Work" );
+        settings->setValue( "profile-1/url", "https://redmine.example.com" );
+        settings->setValue( "profile-1/numRecentIssues", 10 );
+        settings->setValue( "profile-1/recentIssues/size", 1 );
+        settings->setValue( "profile-1/recentIssues/1/id", 42 );
+        settings->setValue( "profile-1/recentIssues/1/subject", "Fix, then \"test\"" );
+        settings->setValue( "profile-3/name", "Home" );
+        settings->setValue( "profile/name", "Not a profile" );
+        settings->setValue( "window/x", 100 );
+        settings->sync();
+        QCOMPARE( settings->status(), QSettings::NoError );
+
+        ProfileStore::Profiles profiles = ProfileStore::profiles();
+        QCOMPARE( profiles.size(), 2 );
+        QCOMPARE( profiles.at(0).id, 1 );
+        QCOMPARE( profiles.at(0).name, QString("Work") );
+        QCOMPARE( profiles.at(1).id, 3 );
+        QCOMPARE( profiles.at(1).name, QString("Home") );
+
+        ProfileStore::Values values;
+        QVERIFY( ProfileStore::load(1, &values) );
+        QCOMPARE( values.value("url").toString(), QString("https://redmine.example.com") );
+        QCOMPARE( values.value("numRecentIssues").toInt(), 10 );
+        QCOMPARE( values.value("recentIssues/size").toInt(), 1 );
+        QCOMPARE( values.value("recentIssues/1/id").toInt(), 42 );
+        QCOMPARE( values.value("recentIssues/1/subject").toString(), QString("Fix, then \"test\"") );
+        QVERIFY( !values.contains("x") );
+
+        QVERIFY( ProfileStore::load(3, &values) );
+        QCOMPARE( values.size(), 1 );
+
+        QVERIFY( !ProfileStore::load(2, &values) );
+        QVERIFY( values.isEmpty() );
+    }
+
+    void importOnce()
+    {
+        QScopedPointer<QSettings> settings( iniSettings() );
+        settings->setValue( "profile-1/name", "Work" );
+        settings->sync();
+
+        QCOMPARE( ProfileStore::profiles().size(), 1 );
+
+        // Once imported, the INI settings file is ignored
+        settings->setValue( "profile-1/name", "Changed" );
+        settings->setValue( "profile-2/name", "New" );
+        settings->sync();
+
+        QVERIFY( ProfileStore::addProfile(1, "Renamed") );
+
+        ProfileStore::Profiles profiles = ProfileStore::profiles();
+        QCOMPARE( profiles.size(), 1 );
+        QCOMPARE( profiles.at(0).name, QString("Renamed") );
+
+        // Without profile index, the profiles are found from their files
+        QVERIFY( QFile::remove(storeDirectory().filePath("profiles.index")) );
+
+        profiles = ProfileStore::profiles();
+        QCOMPARE( profiles.size(), 1 );
+        QCOMPARE( profiles.at(0).id, 1 );
+    }
+};
+
+QTEST_GUILESS_MAIN( ProfileStoreTest )
+
+#include "ProfileStoreTest.moc"
@@ -0,0 +1,6 @@
+TARGET = tst_timeentryjournal
+
+SOURCES += \
+    TimeEntryJournalTest.cpp
+
+include($$PWD/../tests.pri)
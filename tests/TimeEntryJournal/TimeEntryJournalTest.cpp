@@ -0,0 +1,299 @@
+#include "redtimer/TimeEntryJournal.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtTest>
+
+using namespace qtredmine;
+using namespace redtimer;
+
+/**
+ * @brief Tests of the TimeEntryJournal file handling
+ */
+class TimeEntryJournalTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Redmine URL without a server, so that every request fails
+    static const QString URL;
+
+    /**
+     * @brief Get the journal file of the first profile
+     *
+     * @return File name, empty if there is no journal file
+     */
+    static QString journalFile()
+    {
+        QDir dir( QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) );
+        dir.cd( "profile-1" );
+
+        QStringList files = dir.entryList( QStringList("journal-*.log"), QDir::Files );
+        return files.isEmpty() ? QString() : dir.filePath( files.first() );
+    }
+
+    /**
+     * @brief Listen for requests and answer every request with the same response
+     *
+     * @param server Server to start
+     * @param status HTTP status line
+     * @param body JSON response body
+     *
+     * @return true if the server is listening, false otherwise
+     */
+    static bool respond( QTcpServer* server, const QByteArray& status, const QByteArray& body )
+    {
+        QByteArray response = "HTTP/1.1 " + status + "\r\n"
+                              "Content-Type: application/json\r\n"
+                              "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                              "Connection: close\r\n\r\n" + body;
+
+        connect( server, &QTcpServer::newConnection, [=]()
+        {
+            QTcpSocket* socket = server->nextPendingConnection();
+            connect( socket, &QTcpSocket::readyRead, [=]()
+            {
+                // Requests are small enough to arrive completely before the response is sent
+                socket->readAll();
+                socket->write( response );
+                socket->disconnectFromHost();
+            } );
+        } );
+
+        return server->listen( QHostAddress::LocalHost );
+    }
+
+    /**
+     * @brief Create a time entry
+     *
+     * @param issueId Issue ID
+     *
+     * @return Time entry
+     */
+    static TimeEntry timeEntry( int issueId )
+    {
+        TimeEntry timeEntry;
+        timeEntry.activity.id = 9;
+        timeEntry.comment = "Comment";
+        timeEntry.hours = 1.5;
+        timeEntry.issue.id = issueId;
+        timeEntry.spentOn = QDate( 2024, 1, 2 );
+        return timeEntry;
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QStandardPaths::setTestModeEnabled( true );
+    }
+
+    void init()
+    {
+        QDir( QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) ).removeRecursively();
+    }
+
+    void reopen()
+    {
+        RedmineSession redmine;
+
+        {
+            TimeEntryJournal journal( &redmine );
+            journal.open( 1, URL );
+            QVERIFY( journal.isEmpty() );
+            QVERIFY( journal.appendTimeEntry(timeEntry(1)) );
+            QVERIFY( journal.appendIssueStatus(1, 3) );
+        }
+
+        TimeEntryJournal journal( &redmine );
+        journal.open( 1, URL );
+        QCOMPARE( journal.size(), 2 );
+
+        // Every Redmine URL has its own journal
+        journal.open( 1, "http://127.0.0.1:2" );
+        QVERIFY( journal.isEmpty() );
+
+        journal.open( 1, URL );
+        QCOMPARE( journal.size(), 2 );
+    }
+
+    void truncatedRecord()
+    {
+        RedmineSession redmine;
+        redmine.setUrl( URL );
+        redmine.setAuthenticator( QString("0123456789abcdef") );
+
+        {
+            TimeEntryJournal journal( &redmine );
+            journal.open( 1, URL );
+            QVERIFY( journal.appendTimeEntry(timeEntry(1)) );
+            QVERIFY( journal.appendIssueStatus(2, 3) );
+            QVERIFY( journal.appendTimeEntry(timeEntry(4)) );
+        }
+
+        // Tear the last record as if writing it had been interrupted
+        QFile file( journalFile() );
+        QVERIFY( file.open(QIODevice::ReadWrite) );
+        QVERIFY( file.resize(file.size() - 3) );
+        file.close();
+
+        TimeEntryJournal journal( &redmine );
+        journal.open( 1, URL );
+        QCOMPARE( journal.size(), 2 );
+
+        // Records appended after the torn one are read again
+        QVERIFY( journal.appendTimeEntry(timeEntry(5)) );
+
+        {
+            TimeEntryJournal reopened( &redmine );
+            reopened.open( 1, URL );
+            QCOMPARE( reopened.size(), 3 );
+        }
+
+        // Entries that could not be delivered stay in the journal
+        QList<int> sentIssueIds;
+        bool success = true;
+        connect( &journal, &TimeEntryJournal::timeEntrySent,
+                 [&]( TimeEntry timeEntry, bool sentSuccess, RedmineError, QStringList )
+        {
+            sentIssueIds.append( timeEntry.issue.id );
+            success = sentSuccess;
+        } );
+
+        journal.replay();
+        QTRY_VERIFY_WITH_TIMEOUT( !sentIssueIds.isEmpty(), 10000 );
+
+        QCOMPARE( sentIssueIds, QList<int>{1} );
+        QVERIFY( !success );
+        QCOMPARE( journal.size(), 3 );
+    }
+
+    void rejected_data()
+    {
+        QTest::addColumn<QByteArray>( "status" );
+        QTest::addColumn<bool>( "rejected" );
+
+        QTest::newRow( "invalid" ) << QByteArray( "422 Unprocessable Entity" ) << true;
+        QTest::newRow( "server error" ) << QByteArray( "500 Internal Server Error" ) << false;
+        QTest::newRow( "proxy error" ) << QByteArray( "502 Bad Gateway" ) << false;
+    }
+
+    void rejected()
+    {
+        QFETCH( QByteArray, status );
+        QFETCH( bool, rejected );
+
+        QTcpServer server;
+        QVERIFY( respond(&server, status, "{\"errors\":[\"Issue is invalid\"]}") );
+
+        QString url = QString("http://127.0.0.1:%1").arg(server.serverPort());
+
+        RedmineSession redmine;
+        redmine.setUrl( url );
+        redmine.setAuthenticator( QString("0123456789abcdef") );
+
+        TimeEntryJournal journal( &redmine );
+        journal.open( 1, url );
+        QVERIFY( journal.appendTimeEntry(timeEntry(1)) );
+
+        QStringList rejectedErrors;
+        connect( &journal, &TimeEntryJournal::timeEntryRejected, [&]( TimeEntry, QStringList errors )
+        {
+            rejectedErrors = errors;
+        } );
+
+        bool sent = false;
+        connect( &journal, &TimeEntryJournal::timeEntrySent, [&]( TimeEntry, bool, RedmineError, QStringList )
+        {
+            sent = true;
+        } );
+
+        journal.replay();
+        QTRY_VERIFY_WITH_TIMEOUT( sent || !rejectedErrors.isEmpty(), 10000 );
+
+        // Only invalid entries are moved to the rejected entries; others stay in the journal to be sent again
+        QCOMPARE( !rejectedErrors.isEmpty(), rejected );
+        QCOMPARE( journal.size(), rejected ? 0 : 1 );
+        QCOMPARE( QFile::exists(journalFile() + ".rejected"), rejected );
+
+        if( rejected )
+            QCOMPARE( rejectedErrors, QStringList("Issue is invalid") );
+    }
+
+    void corruptRecord()
+    {
+        RedmineSession redmine;
+
+        {
+            TimeEntryJournal journal( &redmine );
+            journal.open( 1, URL );
+            QVERIFY( journal.appendTimeEntry(timeEntry(1)) );
+            QVERIFY( journal.appendTimeEntry(timeEntry(2)) );
+        }
+
+        // Flip the last byte so that the checksum of the last record does not match
+        QFile file( journalFile() );
+        QVERIFY( file.open(QIODevice::ReadWrite) );
+        QVERIFY( file.seek(file.size() - 1) );
+        char last;
+        QVERIFY( file.getChar(&last) );
+        QVERIFY( file.seek(file.size() - 1) );
+        QVERIFY( file.putChar(last ^ 0x01) );
+        file.close();
+
+        TimeEntryJournal journal( &redmine );
+        journal.open( 1, URL );
+        QCOMPARE( journal.size(), 1 );
+    }
+
+    void corruptMiddleRecord()
+    {
+        RedmineSession redmine;
+        qint64 middle;
+
+        {
+            TimeEntryJournal journal( &redmine );
+            journal.open( 1, URL );
+            QVERIFY( journal.appendTimeEntry(timeEntry(1)) );
+            middle = QFileInfo( journalFile() ).size();
+            QVERIFY( journal.appendTimeEntry(timeEntry(2)) );
+            QVERIFY( journal.appendTimeEntry(timeEntry(3)) );
+        }
+
+        // Flip the last byte of the second record
+        QFile file( journalFile() );
+        QVERIFY( file.open(QIODevice::ReadWrite) );
+        qint64 end = middle + (file.size() - middle) / 2;
+        QVERIFY( file.seek(end - 1) );
+        char last;
+        QVERIFY( file.getChar(&last) );
+        QVERIFY( file.seek(end - 1) );
+        QVERIFY( file.putChar(last ^ 0x01) );
+        file.close();
+
+        // Only the corrupt record is skipped, and the corrupt journal is kept
+        {
+            TimeEntryJournal journal( &redmine );
+            journal.open( 1, URL );
+            QCOMPARE( journal.size(), 2 );
+        }
+
+        QDir dir( QFileInfo(journalFile()).absoluteDir() );
+        QCOMPARE( dir.entryList(QStringList("journal-*.corrupt"), QDir::Files).size(), 1 );
+
+        // The rewritten journal is read without corruption
+        TimeEntryJournal journal( &redmine );
+        journal.open( 1, URL );
+        QCOMPARE( journal.size(), 2 );
+        QCOMPARE( dir.entryList(QStringList("journal-*.corrupt"), QDir::Files).size(), 1 );
+    }
+};
+
+const QString TimeEntryJournalTest::URL = "http://127.0.0.1:1";
+
+QTEST_GUILESS_MAIN( TimeEntryJournalTest )
+
+#include "TimeEntryJournalTest.moc"
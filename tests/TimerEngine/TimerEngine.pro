@@ -0,0 +1,6 @@
+TARGET = tst_timerengine
+
+SOURCES += \
+    TimerEngineTest.cpp
+
+include($$PWD/../tests.pri)
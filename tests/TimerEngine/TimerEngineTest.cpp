@@ -0,0 +1,206 @@
+#include "redtimer/TimerEngine.h"
+
+#include <QtTest>
+
+using namespace redtimer;
+
+/**
+ * @brief Tests of the TimerEngine with fake clocks
+ */
+class TimerEngineTest : public QObject
+{
+    Q_OBJECT
+
+private:
+    /// Fake monotonic clock in milliseconds
+    qint64 monotonic_ = 0;
+
+    /// Fake boot clock in milliseconds
+    qint64 boot_ = 0;
+
+    /**
+     * @brief Create an engine that uses the fake clocks
+     *
+     * @return Timer engine
+     */
+    TimerEngine engine()
+    {
+        return TimerEngine( [this]{ return monotonic_; }, [this]{ return boot_; } );
+    }
+
+    /**
+     * @brief Let time pass while the system is running
+     *
+     * @param msecs Milliseconds
+     */
+    void advance( qint64 msecs )
+    {
+        monotonic_ += msecs;
+        boot_ += msecs;
+    }
+
+    /**
+     * @brief Let time pass while the system is suspended
+     *
+     * @param msecs Milliseconds
+     */
+    void suspend( qint64 msecs )
+    {
+        boot_ += msecs;
+    }
+
+private slots:
+    void init()
+    {
+        // Clocks have arbitrary and different references
+        monotonic_ = 1000;
+        boot_ = 500000;
+    }
+
+    void startStop()
+    {
+        TimerEngine engine = this->engine();
+        QVERIFY( !engine.isRunning() );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(0) );
+
+        engine.start();
+        QVERIFY( engine.isRunning() );
+        advance( 1500 );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(1500) );
+        QCOMPARE( engine.seconds(), 1 );
+
+        engine.stop();
+        QVERIFY( !engine.isRunning() );
+        advance( 10000 );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(1500) );
+
+        // Segments add up
+        engine.start();
+        advance( 2500 );
+        engine.stop();
+        QCOMPARE( engine.elapsed(), Q_INT64_C(4000) );
+        QCOMPARE( engine.seconds(), 4 );
+    }
+
+    void startStopTwice()
+    {
+        TimerEngine engine = this->engine();
+
+        engine.start();
+        advance( 1000 );
+        engine.start();
+        advance( 1000 );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(2000) );
+
+        engine.stop();
+        engine.stop();
+        QCOMPARE( engine.elapsed(), Q_INT64_C(2000) );
+    }
+
+    void reset()
+    {
+        TimerEngine engine = this->engine();
+
+        engine.start();
+        advance( 5000 );
+        engine.setElapsed( 60000 );
+        suspend( 120000 );
+        QCOMPARE( engine.suspended(), Q_INT64_C(120000) );
+
+        // A running engine keeps running from zero
+        engine.reset();
+        QVERIFY( engine.isRunning() );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(0) );
+        QCOMPARE( engine.suspended(), Q_INT64_C(0) );
+
+        advance( 3000 );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(3000) );
+
+        engine.stop();
+        engine.reset();
+        QVERIFY( !engine.isRunning() );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(0) );
+    }
+
+    void setElapsed()
+    {
+        TimerEngine engine = this->engine();
+
+        engine.setElapsed( 90000 );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(90000) );
+
+        // The adjustment is kept while the engine is running
+        engine.start();
+        advance( 1000 );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(91000) );
+
+        engine.setElapsed( 30000 );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(30000) );
+        advance( 1000 );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(31000) );
+
+        engine.stop();
+        QCOMPARE( engine.elapsed(), Q_INT64_C(31000) );
+
+        // The tracked time may be lowered below the time of the closed segments
+        engine.setElapsed( 0 );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(0) );
+    }
+
+    void suspended()
+    {
+        TimerEngine engine = this->engine();
+
+        engine.start();
+        advance( 1000 );
+        suspend( 120000 );
+        advance( 1000 );
+
+        // Suspended time is reported but not tracked
+        QCOMPARE( engine.elapsed(), Q_INT64_C(2000) );
+        QCOMPARE( engine.suspended(), Q_INT64_C(120000) );
+
+        engine.stop();
+        QCOMPARE( engine.suspended(), Q_INT64_C(120000) );
+
+        // Gaps of closed segments add up
+        engine.start();
+        suspend( 90000 );
+        engine.stop();
+        QCOMPARE( engine.suspended(), Q_INT64_C(210000) );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(2000) );
+    }
+
+    void suspendedBelowThreshold()
+    {
+        TimerEngine engine = this->engine();
+
+        engine.start();
+        suspend( TimerEngine::SUSPEND_THRESHOLD - 1 );
+        QCOMPARE( engine.suspended(), Q_INT64_C(0) );
+
+        suspend( 1 );
+        QCOMPARE( engine.suspended(), TimerEngine::SUSPEND_THRESHOLD );
+    }
+
+    void suspendedWhileStopped()
+    {
+        TimerEngine engine = this->engine();
+
+        engine.start();
+        advance( 1000 );
+        engine.stop();
+
+        suspend( 120000 );
+        QCOMPARE( engine.suspended(), Q_INT64_C(0) );
+
+        engine.start();
+        advance( 1000 );
+        QCOMPARE( engine.suspended(), Q_INT64_C(0) );
+        QCOMPARE( engine.elapsed(), Q_INT64_C(2000) );
+    }
+};
+
+QTEST_GUILESS_MAIN( TimerEngineTest )
+
+#include "TimerEngineTest.moc"
@@ -0,0 +1,12 @@
+QT += core network testlib
+QT -= gui
+
+CONFIG += c++14
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+TEMPLATE = app
+
+# External projects
+include($$PWD/../libqtredmine/qtredmine.pri)
+include($$PWD/../libredtimer/libredtimer.pri)
@@ -0,0 +1,13 @@
+TEMPLATE = subdirs
+
+SUBDIRS = \
+    IssueCache \
+    IssueFilter \
+    IssueIndex \
+    JsonListReader \
+    ProfileStore \
+    TimeEntryJournal \
+    TimerEngine
+
+DISTFILES += \
+    tests.pri